@@ -0,0 +1,57 @@
+/*
+Arena.hpp
+A file that contains the declaration of the Arena class, the memory a DirectedGraph keeps its vertices and edge lists in.
+An Arena hands out memory by bumping a pointer through chunks taken from the heap, so a graph of millions of vertices
+costs a few hundred large allocations instead of millions of small ones, its vertices and lists lie next to each other
+in the order they were created, and it is given back all at once. Chunks grow from 4 KB up to 1 MB, so small graphs
+stay small and a big one wastes at most the unused end of its last chunk; a request bigger than a quarter of the
+largest chunk gets a chunk of its own. Memory given back with deallocate is not reused until the arena is released.
+It is a std::pmr::memory_resource, so pmr containers can allocate from it. It is not safe to use from several threads.
+Written by: Khoi V.
+*/
+#pragma once
+
+#include <vector>
+#include <cstddef> // for std::size_t, std::max_align_t
+#include <memory_resource> // for std::pmr::memory_resource
+
+using namespace std;
+
+class Arena : public pmr::memory_resource {
+public:
+    // Size of the first chunk and of the largest chunk the arena grows to, in bytes
+    static constexpr size_t MIN_CHUNK = size_t(1) << 12;
+    static constexpr size_t MAX_CHUNK = size_t(1) << 20;
+
+    Arena() = default;
+    // Gives every chunk back to the heap
+    ~Arena();
+
+    // The memory belongs to the objects placed in it, so an arena cannot be copied
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // Gives every chunk back to the heap; everything allocated from the arena is gone
+    void release();
+    // Bytes taken from the heap
+    size_t capacity() const;
+    // Bytes handed out since the arena was created or released (deallocate does not lower it)
+    size_t used() const;
+
+private:
+    vector<char*> chunks; // every chunk taken from the heap
+    char* next = nullptr; // first free byte of the current chunk
+    char* end = nullptr; // end of the current chunk
+    size_t chunkSize = MIN_CHUNK; // size of the next chunk
+    size_t taken = 0; // bytes in chunks
+    size_t handedOut = 0; // bytes handed out
+
+    // Takes a chunk of the given size from the heap
+    char* newChunk(size_t bytes);
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const pmr::memory_resource& other) const noexcept override;
+};
+
+#include "Arena.tpp"
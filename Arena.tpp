@@ -0,0 +1,97 @@
+/*
+Arena.tpp
+A file that contains the implementation of the Arena class.
+Written by: Khoi V.
+*/
+#include "Arena.hpp"
+#include <new> // for ::operator new
+#include <algorithm> // for std::max, std::min
+#include <cstdint> // for std::uintptr_t
+
+// Destructor
+// Parameters: None.
+// Return value: None.
+inline Arena::~Arena() {
+    release();
+}
+
+// Function to give the memory back
+// Parameters: None.
+// Return value: None.
+// The next allocation starts again with a small chunk.
+inline void Arena::release() {
+    for (char* chunk : chunks) {
+        ::operator delete(chunk);
+    }
+    chunks.clear();
+    next = end = nullptr;
+    chunkSize = MIN_CHUNK;
+    taken = handedOut = 0;
+}
+
+// Function to get the memory taken from the heap
+// Parameters: None.
+// Return value: The total size of the chunks in bytes.
+inline size_t Arena::capacity() const {
+    return taken;
+}
+
+// Function to get the memory handed out
+// Parameters: None.
+// Return value: The bytes allocated from the arena since it was created or released.
+inline size_t Arena::used() const {
+    return handedOut;
+}
+
+// Function to take a chunk from the heap
+// Parameters: bytes - the size of the chunk.
+// Return value: The chunk, which the arena frees on release.
+inline char* Arena::newChunk(size_t bytes) {
+    // release frees only the chunks it finds in chunks, so the slot is reserved before the chunk exists
+    if (chunks.size() == chunks.capacity()) chunks.reserve(max<size_t>(16, 2 * chunks.size()));
+    char* chunk = static_cast<char*>(::operator new(bytes));
+    chunks.push_back(chunk);
+    taken += bytes;
+    return chunk;
+}
+
+// Function to allocate memory
+// Description: Bumps the free pointer of the current chunk, after aligning it; when the chunk is full, a new one
+// twice the size of the last (up to MAX_CHUNK) becomes current. Big requests get a chunk of their own, so the
+// rest of the current chunk is not wasted.
+// Parameters: bytes - the size wanted, alignment - its alignment (a power of two).
+// Return value: The memory.
+// It throws std::bad_alloc if the heap is out of memory.
+inline void* Arena::do_allocate(size_t bytes, size_t alignment) {
+    handedOut += bytes;
+    size_t padding = alignment > alignof(max_align_t) ? alignment : 0;
+    if (bytes > MAX_CHUNK / 4) {
+        char* chunk = newChunk(bytes + padding);
+        return chunk + ((alignment - reinterpret_cast<uintptr_t>(chunk) % alignment) % alignment);
+    }
+    size_t skip = next == nullptr ? 0 : (alignment - reinterpret_cast<uintptr_t>(next) % alignment) % alignment;
+    if (next == nullptr || static_cast<size_t>(end - next) < skip + bytes) {
+        size_t size = max(chunkSize, bytes + padding);
+        next = newChunk(size);
+        end = next + size;
+        chunkSize = min(chunkSize * 2, MAX_CHUNK);
+        skip = (alignment - reinterpret_cast<uintptr_t>(next) % alignment) % alignment;
+    }
+    void* p = next + skip;
+    next += skip + bytes;
+    return p;
+}
+
+// Function to give memory back
+// Parameters: p, bytes, alignment - the memory, as allocated.
+// Return value: None.
+// Note: Does nothing; the memory is reclaimed when the arena is released.
+inline void Arena::do_deallocate(void*, size_t, size_t) {
+}
+
+// Function to compare memory resources
+// Parameters: other - the other resource.
+// Return value: true only for the arena itself, as memory from one arena cannot be given back to another.
+inline bool Arena::do_is_equal(const pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
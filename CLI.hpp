@@ -10,38 +10,133 @@ Written by: Khoi V.
 #include <vector>
 #include "DirectedGraph.hpp"
 #include "Vertex.hpp"
+#include "GreatCircleHeuristic.hpp"
+#include "ContractionHierarchy.hpp"
+#include "GraphFile.hpp"
+#include "GraphImage.hpp"
+#include "SpatialIndex.hpp"
+#include "QueryExecutor.hpp"
 
 using namespace std;
 
+// Search algorithms find_path can use
+enum class SearchMode { DIJKSTRA, BIDIRECTIONAL, ASTAR, CH };
+
 class GraphMap {
 private:
     // Graph representation
     // The graph is represented as a directed graph with vertices of type size_t
     DirectedGraph<size_t> G;
-    // Maps to store vertex IDs, coordinates, and names
-    // ID[x][y] = id, where id is the vertex ID for coordinates (x,y)
-    unordered_map<double, unordered_map<double, size_t>> ID;
-    // Coor[id] = (x,y), where id is the vertex ID and (x,y) are the coordinates
-    unordered_map<size_t, pair<double,double>> Coor;
-    // Name[u][v] = name, where u and v are vertex IDs and name is the edge name
-    // This is used to store the names of edges between vertices u and v
-    unordered_map<size_t, unordered_map<size_t,string>> Name;
-    // Maps to store vertex pointers
-    // vertexMap[id] = vertex pointer, where id is the vertex ID and vertex pointer is a pointer to the Vertex object
-    unordered_map<size_t, Vertex<size_t>*> vertexMap;
+    // coorOf[i] = (x,y) of the vertex with index i in the graph snapshot, for the A* heuristic
+    vector<pair<double,double>> coorOf;
+    // Binary image the graph was loaded from, or nullptr for a text graph
+    GraphImage<size_t>* image = nullptr;
+    // The graph searched by find_path: the snapshot of G, or the graph of the image
+    const CSRGraph<size_t>* net = nullptr;
+    // coords[i] = (x,y) of vertex i of net: coorOf, or the coordinates of the image
+    const pair<double,double>* coords = nullptr;
+    // Lower bound on the cost per metre of any edge, for the A* heuristic
+    double costPerMetre = 0.0;
+    // Search algorithm used by find_path
+    SearchMode mode = SearchMode::BIDIRECTIONAL;
+    // Contraction hierarchy of the graph, built by load_file in CH mode
+    ContractionHierarchy<size_t> ch;
+    // Per-search state, reused by every find_path call
+    SearchContext ctx;
+    // Spatial indexes of the vertices and edges of net, built by the first lookup that needs them
+    SpatialIndex vertexIndex, edgeIndex;
+    bool indexed = false;
+    // Shortest-path trees of recent start vertices for an image (a text graph uses the cache of G)
+    ShortestPathTreeCache imageTrees;
+    // Print the stats of every find_path query and the latency histograms on quit (builds with ROUTE_STATS only)
+    bool showStats = false;
+    // File the latency histograms are written to as JSON on quit, or empty
+    string statsFile;
+    // Limits of the alternative routes find_path prints after the shortest one (count 1, the default, prints none)
+    AlternativeLimits alternativeLimits{1};
+
+    // Where an input point joins the graph: at a vertex, or part-way along an edge
+    struct Snap {
+        size_t vertex; // the vertex the search starts or ends at
+        double offset; // cost of the part of the edge between the point and that vertex (0 at a vertex)
+        size_t edge; // the edge the point lies on, or CSRGraph<size_t>::NONE if it is at the vertex
+        double fraction; // where the point lies along the edge, 0 at its tail and 1 at its head
+        pair<double,double> point; // the snapped point
+    };
+
+    // The shortest-path tree cache of net
+    ShortestPathTreeCache& trees();
+    // Builds the spatial indexes if they are not built yet
+    void build_indexes();
+    // Index in net of the vertex at exactly (x,y), or CSRGraph<size_t>::NONE
+    size_t vertexAt(double x, double y);
+    // Snaps (x,y) to the nearest point of the road network; a start point leaves along its edge, an end point arrives
+    Snap snap(double x, double y, bool start);
+    // Route between two snapped points with the selected search algorithm; fills the vertex path, the points along
+    // the route and the road names between them, and returns the distance (infinity if there is no route)
+    double route(SearchContext& c, const Snap& from, const Snap& to, vector<size_t>& path,
+                 vector<pair<double,double>>& pts, vector<string>& names, size_t& settled);
+    // Points along the vertex path of a route between two snapped points (the snapped points included when they lie
+    // on an edge) and the road names between them
+    void trace(const Snap& from, const Snap& to, const vector<size_t>& path,
+               vector<pair<double,double>>& pts, vector<string>& names) const;
+    // Turn-by-turn directions for the points and road names of a route
+    static vector<string> directions(const vector<pair<double,double>>& pts, const vector<string>& names);
+    // Answers one batch query line, appending the result line to out; false if the line is malformed
+    bool answer(SearchContext& c, const string& line, size_t lineNo, bool withDirections, string& out);
 
 public:
-    // Loads the graph from a file
+    GraphMap() = default;
+    // Unmaps the image, if any
+    ~GraphMap();
+    // The map may own a mapped image, so it cannot be copied
+    GraphMap(const GraphMap&) = delete;
+    GraphMap& operator=(const GraphMap&) = delete;
+
+    // Asks for a file name and loads the graph from it
     bool load_file();
+    // Loads the graph from a text graph file or a binary image (detected from the file contents)
+    // Prints an error message and returns false if the file cannot be loaded
+    bool load(const string& file_name);
+    // Writes the loaded graph as a binary image; throws std::runtime_error if it cannot be written
+    void save(const string& file_name) const;
+    // Answers every query line "sx sy ex ey" of in, writing one tab-separated result line per query to out
+    // (line number, distance and vertex IDs, optionally directions), using the given number of threads (0 = all cores)
+    // Returns 0 if all queries were answered, 2 if some line was malformed, 1 on an input or output error or if a block
+    // of queries failed as a whole
+    int run_batch(istream& in, ostream& out, bool withDirections = false, size_t threads = 0);
     // Gets the start and end coordinates from the user
     void get_coordinates(double &sx, double &sy, double &ex, double &ey);
     // Validates the input coordinates
     // Checks if the start and end coordinates are valid
     bool validate_input(double sx, double sy, double ex, double ey);
+    // Selects the search algorithm used by find_path
+    // Note: CH mode must be selected before load_file, which builds the hierarchy
+    void set_mode(SearchMode m);
+    // Answers routes from cached shortest-path trees of the start vertices, keeping at most the given number of bytes
+    // of trees (0, the default, searches every route afresh)
+    void set_tree_cache(size_t bytes);
+    // Hit, miss and eviction counts of the shortest-path tree cache
+    ShortestPathTreeCache::Stats tree_cache_stats();
+    // Selects what to report of the search statistics: show prints the stats of every find_path query and the latency
+    // histograms, dumpFile (if not empty) receives the histograms as JSON; both need a build with -DROUTE_STATS
+    void set_stats(bool show, const string& dumpFile);
+    // Selects the alternative routes find_path prints after the shortest one: up to limits.count - 1 of them, each at
+    // most limits.maxStretch longer than the shortest; throws std::invalid_argument if the limits are invalid
+    void set_alternatives(const AlternativeLimits& limits);
+    // Prints the latency histograms to err and writes the dump file, as selected by set_stats
+    // Returns false if the dump file cannot be written
+    bool report_stats(ostream& err) const;
     // Finds the shortest path between the start and end coordinates
-    // Uses Dijkstra's algorithm to find the shortest path
-    // Prints the shortest path and turn-by-turn directions
+    // Uses the selected search algorithm to find the shortest path
+    // Prints the shortest path and turn-by-turn directions, then those of the alternative routes, if selected
     void find_path();
+    // Isochrone: every vertex reachable within budget of any of the start points, each snapped to the road network
+    // like the start of a route; returns its coordinates and the cost from the nearest start, nearest first
+    // The search stops at the budget, so its work grows with the area reached rather than the whole map
+    vector<pair<pair<double,double>, double>> isochrone(const vector<pair<double,double>>& starts, double budget);
+    // Same from one start point
+    vector<pair<pair<double,double>, double>> isochrone(double x, double y, double budget);
     // Quits the program
     void quit();
 };
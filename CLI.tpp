@@ -10,56 +10,179 @@ Written by: Khoi V, Duc T.
 #include <sstream>
 #include <algorithm>
 #include <cmath>
+#include <charconv> // for std::from_chars, std::to_chars
+#include <deque>
+#include <future> // for std::promise
+#include <memory> // for std::unique_ptr
+#include <stdexcept> // for std::invalid_argument
+
+// Destructor
+// Parameters: None.
+// Return value: None.
+// Written by: Khoi V.
+GraphMap::~GraphMap() {
+    delete image;
+}
 
 // Function to load the graph from a file
 // Parameters: None.
 // Return value: true if the graph is successfully loaded, false otherwise.
 // If the user enters 'q', the program quits.
-// If it fails to open the file, an error message is displayed and the user is prompted to try again.
+// If it fails to open or parse the file, an error message is displayed and the user is prompted to try again.
 // Written by: Duc T.
 bool GraphMap::load_file() {
     string file_name;
     cout << "Enter a file name to load, or press 'q' to quit: ";
     cin >> file_name;
     if (file_name == "q") quit();
-    ifstream file(file_name);
-    if (!file.is_open()) {
+    if (!load(file_name)) {
         cout << "Error opening file!" << endl;
         return false;
     }
+    cout << "Graph successfully loaded!" << endl;
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    return true;
+}
+
+// Function to load the graph from a named file
+// Parameters: file_name - a text graph file or a binary image written by save.
+// Return value: true if the graph is successfully loaded, false otherwise.
+// A binary image is mapped and searched in place; a text graph is parsed into G.
+// If it fails to open or parse the file, the reason is written to cerr.
+// Written by: Duc T., Khoi V.
+bool GraphMap::load(const string& file_name) {
+    if (GraphImage<size_t>::isImage(file_name)) {
+        try {
+            image = new GraphImage<size_t>(file_name);
+        } catch (const runtime_error& e) {
+            cerr << e.what() << endl;
+            return false;
+        }
+        net = &image->graph();
+        coords = image->coordinates();
+        costPerMetre = image->minCostPerMetre();
+        if (mode == SearchMode::CH) {
+            ch = ContractionHierarchy<size_t>(*net);
+        }
+        return true;
+    }
+
+    // Parse the whole file first (memory-mapped, edges on several threads), so a bad file changes nothing
+    vector<GraphFile::Edge> edges;
+    vector<size_t> ids;
+    try {
+        GraphFile file(file_name);
+        ids = move(file.ids);
+        coorOf = move(file.coords);
+        edges = move(file.edges);
+    } catch (const runtime_error& e) {
+        cerr << e.what() << endl;
+        return false;
+    }
 
-    // Read the number of vertices and edges
-    size_t n,m;
-    file >> n >> m;
-    // Read vertices and create them
+    // Check the IDs before G is touched: indexOf[id] = the position of the vertex with that ID in the file
+    size_t n = ids.size();
+    unordered_map<size_t, size_t> indexOf;
+    indexOf.reserve(n);
     for (size_t i = 0; i < n; ++i) {
-        size_t id; double x,y;
-        file >> id >> x >> y;
-        ID[x][y] = id;
-        Coor[id]  = {x,y};
-        auto v = new Vertex<size_t>(id);
-        G.addVertex(v);
-        vertexMap[id] = v;
-    }
-    file.ignore(numeric_limits<streamsize>::max(), '\n');
-    // Read edges and add them to the graph
-    for (size_t i = 0; i < m; ++i) {
-        size_t u,v; double w;
-        file >> u >> v >> w;
-        string s;
-        if (file.peek()==' ') {
-            file.get();
-            getline(file,s);
+        if (!indexOf.emplace(ids[i], i).second) {
+            cerr << "Duplicate vertex ID " << ids[i] << " in vertex line " << i + 1 << endl;
+            return false;
         }
-        Name[u][v] = s;
-        G.addEdge(vertexMap[u], vertexMap[v], w, s);
     }
-    file.close();
-    cout << "Graph successfully loaded!" << endl;
-    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    // Count the degrees, so the edge lists can be sized (the arena does not reuse the memory of lists that grow)
+    vector<size_t> outDegree(n, 0), inDegree(n, 0);
+    vector<pair<size_t, size_t>> ends(edges.size());
+    for (size_t k = 0; k < edges.size(); ++k) {
+        for (size_t id : {edges[k].from, edges[k].to}) {
+            if (indexOf.find(id) == indexOf.end()) {
+                cerr << "Unknown vertex ID " << id << " in edge line " << k + 1 << endl;
+                return false;
+            }
+        }
+        ends[k] = {indexOf.find(edges[k].from)->second, indexOf.find(edges[k].to)->second};
+        outDegree[ends[k].first]++;
+        inDegree[ends[k].second]++;
+    }
+
+    // Create the vertices in the arena of the graph
+    vector<Vertex<size_t>*> created(n);
+    for (size_t i = 0; i < n; ++i) {
+        created[i] = G.createVertex(ids[i]);
+        created[i]->reserveEdges(outDegree[i], inDegree[i]);
+    }
+    // Add the edges; the name is the rest of the line after the single space that follows the weight
+    for (size_t k = 0; k < edges.size(); ++k) {
+        auto &e = edges[k];
+        string_view s = e.rest.size() > 0 && e.rest[0] == ' ' ? string_view(e.rest).substr(1) : string_view();
+        G.addEdge(created[ends[k].first], created[ends[k].second], e.weight, s);
+    }
+    net = &G.snapshot();
+    coords = coorOf.data();
+    costPerMetre = GreatCircleHeuristic::minCostPerMetre(*net, coords);
+    if (mode == SearchMode::CH) {
+        ch = ContractionHierarchy<size_t>(*net);
+    }
     return true;
 }
 
+// Function to save the loaded graph as a binary image
+// Parameters: file_name - the file to write.
+// Return value: None.
+// It throws std::runtime_error if the file cannot be written.
+// Written by: Khoi V.
+void GraphMap::save(const string& file_name) const {
+    GraphImage<size_t>::write(file_name, *net, vector<pair<double,double>>(coords, coords + net->numVertices()));
+}
+
+// Function to build the spatial indexes of the vertices and edges
+// Parameters: None.
+// Return value: None.
+// They are built on first use, so a mapped image starts serving exact-coordinate queries at once.
+// Written by: Khoi V.
+void GraphMap::build_indexes() {
+    if (indexed) return;
+    double xScale = SpatialIndex::lonScale(coords, net->numVertices());
+    vertexIndex = SpatialIndex(coords, net->numVertices(), xScale);
+    edgeIndex = SpatialIndex(*net, coords, xScale);
+    indexed = true;
+}
+
+// Function to find the vertex at the given coordinates
+// Parameters: x, y - the coordinates.
+// Return value: The index in net of the vertex at exactly (x,y), or CSRGraph<size_t>::NONE if there is none.
+// Written by: Khoi V.
+size_t GraphMap::vertexAt(double x, double y) {
+    if (image) return image->findCoordinate(x, y);
+    build_indexes();
+    SpatialIndex::Match m = vertexIndex.nearest(x, y);
+    return m.distance == 0.0 ? m.id : CSRGraph<size_t>::NONE;
+}
+
+// Function to snap a point to the road network
+// Parameters: x, y - the coordinates, start - true for the start of a route, false for its end.
+// Return value: Where the point joins the graph. A point on a vertex snaps to it. Otherwise the point snaps to
+// the nearest point of the nearest edge u -> v: a start joins the graph at v, after the rest of the edge,
+// and an end at u, before the first part of the edge. A graph without edges snaps to the nearest vertex.
+// Written by: Khoi V.
+GraphMap::Snap GraphMap::snap(double x, double y, bool start) {
+    const size_t NONE = CSRGraph<size_t>::NONE;
+    size_t v = vertexAt(x, y);
+    if (v != NONE) return Snap{v, 0.0, NONE, 0.0, coords[v]};
+    build_indexes();
+    if (edgeIndex.size() == 0) {
+        SpatialIndex::Match m = vertexIndex.nearest(x, y);
+        return Snap{m.id, 0.0, NONE, 0.0, m.point};
+    }
+    SpatialIndex::Match m = edgeIndex.nearest(x, y);
+    size_t tail = net->edgeSource(m.id), head = net->edgeTarget(m.id);
+    if (m.fraction == 0.0) return Snap{tail, 0.0, NONE, 0.0, coords[tail]};
+    if (m.fraction == 1.0) return Snap{head, 0.0, NONE, 0.0, coords[head]};
+    double w = net->edgeWeight(m.id);
+    if (start) return Snap{head, (1.0 - m.fraction) * w, m.id, m.fraction, m.point};
+    return Snap{tail, m.fraction * w, m.id, m.fraction, m.point};
+}
+
 // Function to get start and end coordinates from the user
 // Parameters: sx, sy - start coordinates; ex, ey - end coordinates.
 // Return value: None.
@@ -89,74 +212,200 @@ void GraphMap::get_coordinates(double &sx,double &sy,double &ex,double &ey) {
 // Function to validate the input coordinates
 // Parameters: sx, sy - start coordinates; ex, ey - end coordinates.
 // Return value: true if the coordinates are valid, false otherwise.
+// Any finite coordinates are valid as long as the graph has a vertex; find_path snaps them to the nearest road.
 // Written by: Duc T.
 bool GraphMap::validate_input(double sx,double sy,double ex,double ey) {
-    if (ID.find(sx)==ID.end() || ID[sx].find(sy)==ID[sx].end()) {
+    if (!isfinite(sx) || !isfinite(sy) || net->numVertices() == 0) {
         cerr<<"Error: Start ("<<sx<<","<<sy<<") not valid!"<<endl;
         return false;
     }
-    if (ID.find(ex)==ID.end() || ID[ex].find(ey)==ID[ex].end()) {
+    if (!isfinite(ex) || !isfinite(ey) || net->numVertices() == 0) {
         cerr<<"Error: End ("<<ex<<","<<ey<<") not valid!"<<endl;
         return false;
     }
     return true;
 }
 
-// Function to find the shortest path using Dijkstra's algorithm
-// Parameters: None.
+// Function to select the search algorithm used by find_path
+// Parameters: m - the search mode.
 // Return value: None.
 // Written by: Khoi V.
-void GraphMap::find_path() {
-    double sx,sy,ex,ey;
-    // Get start and end coordinates from the user
-    // Validate the input coordinates
-    do {
-        get_coordinates(sx,sy,ex,ey);
-    } while (!validate_input(sx,sy,ex,ey));
+void GraphMap::set_mode(SearchMode m) {
+    mode = m;
+}
 
-    // Get vertex IDs for start and end coordinates
-    size_t sid = ID[sx][sy], eid = ID[ex][ey];
-    auto startV = vertexMap[sid], endV = vertexMap[eid];
+// Function to set the budget of the shortest-path tree cache
+// Parameters: bytes - the most memory the cached trees may use; 0 disables the cache.
+// Return value: None.
+// Written by: Khoi V.
+void GraphMap::set_tree_cache(size_t bytes) {
+    G.setTreeCacheBudget(bytes);
+    imageTrees.setBudget(bytes);
+}
 
-    // Perform Dijkstra's algorithm
-    // Find the shortest path from startV to all other vertices
-    G.Dijkstra(startV);
-    double dist = endV->getDistance();
-    if (dist== numeric_limits<double>::infinity()) {
-        cout<<"No path found!"<<endl;
-        return;
+// Function to get the counters of the shortest-path tree cache
+// Parameters: None.
+// Return value: The hits, misses and evictions so far and the trees and bytes held now.
+// Written by: Khoi V.
+ShortestPathTreeCache::Stats GraphMap::tree_cache_stats() {
+    return trees().stats();
+}
+
+// Function to select the search statistics to report
+// Parameters: show - true to print per-query stats and the histograms, dumpFile - the JSON file, or empty for none.
+// Return value: None.
+// In a build without ROUTE_STATS there is nothing to report, so it only warns.
+// Written by: Khoi V.
+void GraphMap::set_stats(bool show, const string& dumpFile) {
+#ifndef ROUTE_STATS
+    if (show || !dumpFile.empty()) cerr<<"Warning: built without -DROUTE_STATS, no search statistics are collected"<<endl;
+#endif
+    showStats = show;
+    statsFile = dumpFile;
+}
+
+// Function to select the alternative routes printed by find_path
+// Parameters: limits - the number of routes (the shortest one included) and how much longer than the shortest and how
+// much alike they may be.
+// Return value: None.
+// It throws std::invalid_argument if maxStretch is negative, or maxOverlap or minPlateau is not in [0,1].
+// Written by: Khoi V.
+void GraphMap::set_alternatives(const AlternativeLimits& limits) {
+    if (!(limits.maxStretch >= 0.0) || !(limits.maxOverlap >= 0.0 && limits.maxOverlap <= 1.0)
+        || !(limits.minPlateau >= 0.0 && limits.minPlateau <= 1.0)) {
+        throw invalid_argument("Alternative route limits out of range");
     }
+    alternativeLimits = limits;
+}
 
-    // Backtrack to find the route
-    vector<size_t> route;
-    for (auto cur=endV; cur; cur=cur->getParent())
-        route.push_back(cur->getValue());
-    reverse(route.begin(),route.end());
+// Function to report the search statistics of the process
+// Parameters: err - the stream the histograms are printed to.
+// Return value: false if the dump file cannot be written, true otherwise.
+// Written by: Khoi V.
+bool GraphMap::report_stats(ostream& err) const {
+#ifdef ROUTE_STATS
+    if (showStats) SearchStatsRegistry::global().print(err);
+    if (!statsFile.empty()) {
+        ofstream dump(statsFile);
+        SearchStatsRegistry::global().dump(dump);
+        if (!dump) {
+            err<<"Error: cannot write "<<statsFile<<endl;
+            return false;
+        }
+    }
+#else
+    (void)err;
+#endif
+    return true;
+}
 
-    // Build coordinate list
-    vector<pair<double,double>> pts;
-    for (auto id : route) pts.push_back(Coor[id]);
+// Function to get the shortest-path tree cache of the searched graph
+// Parameters: None.
+// Return value: The cache of the image if one is loaded, otherwise the cache of G, which G clears when it changes.
+// Written by: Khoi V.
+ShortestPathTreeCache& GraphMap::trees() {
+    return image != nullptr ? imageTrees : G.treeCache();
+}
 
-    // Print shortest route
-    cout<<"Shortest path from ("<<sx<<","<<sy<<") to ("<<ex<<","<<ey<<") is: "<<endl;
-    for (size_t i=0;i<route.size();++i) {
-        auto [x,y] = Coor[route[i]];
-        cout<<"("<<x<<","<<y<<")";
-        if (i+1<route.size()) {
-            cout<<" -> ";
-            auto nm = Name[route[i]][route[i+1]];
-            if (!nm.empty()) cout<<"("<<nm<<") -> "<<endl;
+// Function to find the route between two snapped points with the selected search algorithm
+// Parameters: c - the search context to use, from - the snapped start, to - the snapped end,
+// path - receives the vertex indices of the route between from.vertex and to.vertex,
+// pts - receives the coordinates along the route, including the snapped points when they lie on an edge,
+// names - receives names[i] = the name of the road from pts[i] to pts[i+1], settled - receives the vertices settled.
+// Return value: The length of the route, or infinity if there is none.
+// It only reads the map, so several threads may call it at once, each with its own context.
+// Written by: Khoi V.
+double GraphMap::route(SearchContext& c, const Snap& from, const Snap& to, vector<size_t>& path,
+                       vector<pair<double,double>>& pts, vector<string>& names, size_t& settled) {
+    size_t s = from.vertex, t = to.vertex;
+    // Search the CSR snapshot of the graph (or the mapped image); every mode stops once the route to t is known,
+    // instead of settling the whole graph
+    settled = 0;
+    double dist;
+    SEARCH_STATS(PhaseTimer searchTimer(c.stats, QueryPhase::SEARCH));
+    // With the tree cache on, a start vertex seen recently needs no search at all; a new one gets its whole tree
+    // computed, which pays off once a few queries share the start
+    if (trees().getBudget() > 0) {
+        bool hit;
+        shared_ptr<const ShortestPathTree> tree = trees().get(*net, c, s, &hit);
+        path = tree->route(t);
+        dist = tree->distance[t];
+        if (!hit) settled = count_if(tree->distance.begin(), tree->distance.end(),
+                                     [](double d) { return d != numeric_limits<double>::infinity(); });
+    } else {
+        switch (mode) {
+        case SearchMode::DIJKSTRA:
+            dist = net->shortestPath(c, s, t, path, &settled);
+            break;
+        case SearchMode::ASTAR:
+            dist = net->aStar(c, s, t, GreatCircleHeuristic(coords, costPerMetre, t), path, &settled);
+            break;
+        case SearchMode::CH:
+            // the hierarchy unpacks its shortcuts, so the route is made of original vertices
+            dist = ch.query(c, s, t, path, &settled);
+            break;
+        default:
+            dist = net->bidirectionalDijkstra(c, s, t, path, &settled);
+            break;
         }
     }
+    dist += from.offset + to.offset;
+    // Both points on the same edge, the start first: drive straight along the edge if that is shorter
+    bool along = from.edge != CSRGraph<size_t>::NONE && from.edge == to.edge && from.fraction <= to.fraction
+              && (to.fraction - from.fraction) * net->edgeWeight(from.edge) <= dist;
+    if (along) {
+        dist = (to.fraction - from.fraction) * net->edgeWeight(from.edge);
+        path.clear();
+    }
+    SEARCH_STATS(searchTimer.stop());
+
+    SEARCH_STATS(PhaseTimer pathTimer(c.stats, QueryPhase::PATH));
+    pts.clear();
+    names.clear();
+    if (dist == numeric_limits<double>::infinity()) return dist;
+    if (along) {
+        pts = {from.point, to.point};
+        names.push_back(string(net->edgeName(from.edge)));
+        return dist;
+    }
+    trace(from, to, path, pts, names);
+    return dist;
+}
 
-    cout << endl;
+// Function to build the coordinate list and the names of the edges along a route
+// Parameters: from - the snapped start, to - the snapped end, path - the vertex indices of the route between
+// from.vertex and to.vertex, pts - receives the coordinates along the route, including the parts of the edges the
+// snapped points lie on, names - receives names[i] = the name of the road from pts[i] to pts[i+1].
+// Return value: None.
+// Written by: Khoi V.
+void GraphMap::trace(const Snap& from, const Snap& to, const vector<size_t>& path,
+                     vector<pair<double,double>>& pts, vector<string>& names) const {
+    pts.clear();
+    names.clear();
+    if (from.edge != CSRGraph<size_t>::NONE) {
+        pts.push_back(from.point);
+        names.push_back(string(net->edgeName(from.edge)));
+    }
+    for (size_t i = 0; i < path.size(); ++i) {
+        pts.push_back(coords[path[i]]);
+        if (i + 1 < path.size()) names.push_back(string(net->edgeName(net->findEdge(path[i], path[i + 1]))));
+    }
+    if (to.edge != CSRGraph<size_t>::NONE) {
+        names.push_back(string(net->edgeName(to.edge)));
+        pts.push_back(to.point);
+    }
+}
 
-    // Print turn-by-turn directions
-    cout<<"Turn-by-turn directions:"<<endl;
-    if (route.size() > 1) {
+// Function to compute turn-by-turn directions
+// Parameters: pts - the coordinates along a route, names - names[i] = the name of the road from pts[i] to pts[i+1].
+// Return value: The directions, one per road segment: "Start on <road>", then "<turn> onto <road>" for every later segment.
+// Written by: Khoi V.
+vector<string> GraphMap::directions(const vector<pair<double,double>>& pts, const vector<string>& names) {
+    vector<string> out;
+    if (pts.size() > 1) {
         // Initial street
-        string street = Name[route[0]][route[1]];
-        cout<<"  Start on "<< (street.empty()?"<unnamed road>":street) <<endl;
+        string street = names[0];
+        out.push_back("Start on " + (street.empty()?"<unnamed road>":street));
     }
 
     // Compute turn directions
@@ -167,18 +416,282 @@ void GraphMap::find_path() {
         return (cross>0 ? "Turn left":"Turn right");
     };
 
-    // Iterate through points to determine turns and print directions
+    // Iterate through points to determine turns
     for (size_t i = 1; i+1 < pts.size(); ++i) {
         auto &P0 = pts[i-1], &P1 = pts[i], &P2 = pts[i+1];
         pair<double,double> A{P1.first-P0.first, P1.second-P0.second};
         pair<double,double> B{P2.first-P1.first, P2.second-P1.second};
         string dir = turnType(A,B);
-        string street = Name[route[i]][route[i+1]];
-        cout<<"  "<<dir<<" onto "<< (street.empty()?"<unnamed road>":street) <<endl;
+        string street = names[i];
+        out.push_back(dir + " onto " + (street.empty()?"<unnamed road>":street));
     }
+    return out;
+}
+
+// Function to find the shortest path using the selected search algorithm
+// Parameters: None.
+// Return value: None.
+// Written by: Khoi V.
+void GraphMap::find_path() {
+    double sx,sy,ex,ey;
+    // Get start and end coordinates from the user
+    // Validate the input coordinates
+    do {
+        get_coordinates(sx,sy,ex,ey);
+    } while (!validate_input(sx,sy,ex,ey));
+    // The query is timed from here, after the user has typed it
+    SEARCH_STATS(QueryScope query(ctx.stats, showStats ? &cout : nullptr));
+
+    // Snap the start and end coordinates to the road network
+    SEARCH_STATS(PhaseTimer snapTimer(ctx.stats, QueryPhase::SNAP));
+    Snap from = snap(sx,sy,true), to = snap(ex,ey,false);
+    SEARCH_STATS(snapTimer.stop());
+    if (from.point != make_pair(sx,sy))
+        cout<<"Start ("<<sx<<","<<sy<<") snapped to ("<<from.point.first<<","<<from.point.second<<")"<<endl;
+    if (to.point != make_pair(ex,ey))
+        cout<<"End ("<<ex<<","<<ey<<") snapped to ("<<to.point.first<<","<<to.point.second<<")"<<endl;
+
+    vector<size_t> path;
+    vector<pair<double,double>> pts;
+    vector<string> names;
+    size_t settled = 0;
+    double dist = route(ctx, from, to, path, pts, names, settled);
+    SEARCH_STATS(PhaseTimer formatTimer(ctx.stats, QueryPhase::FORMAT));
+    if (dist== numeric_limits<double>::infinity()) {
+        cout<<"No path found!"<<endl;
+        return;
+    }
+
+    // Print a route: its points and road names, then its turn-by-turn directions
+    auto print = [&](const vector<pair<double,double>>& pts, const vector<string>& names) {
+        for (size_t i=0;i<pts.size();++i) {
+            auto [x,y] = pts[i];
+            cout<<"("<<x<<","<<y<<")";
+            if (i+1<pts.size()) {
+                cout<<" -> ";
+                auto nm = names[i];
+                if (!nm.empty()) cout<<"("<<nm<<") -> "<<endl;
+            }
+        }
+
+        cout << endl;
+
+        // Print turn-by-turn directions
+        cout<<"Turn-by-turn directions:"<<endl;
+        for (auto &line : directions(pts, names)) {
+            cout<<"  "<<line<<endl;
+        }
+
+        cout<<"  Arrive at destination ("<<ex<<","<<ey<<")"<<endl;
+    };
 
-    cout<<"  Arrive at destination ("<<ex<<","<<ey<<")"<<endl;
+    // Print shortest route
+    cout<<"Shortest path from ("<<sx<<","<<sy<<") to ("<<ex<<","<<ey<<") is: "<<endl;
+    print(pts, names);
     cout<<"Total distance = "<<dist<<endl;
+    cout<<"Vertices settled = "<<settled<<endl;
+
+    // Alternatives come from one more pair of searches between the snapped vertices; a route straight along the edge
+    // both points lie on has none
+    if (alternativeLimits.count < 2 || path.empty()) return;
+    vector<vector<size_t>> paths;
+    vector<double> lengths;
+    net->alternatives(ctx, from.vertex, to.vertex, alternativeLimits, paths, lengths, &settled);
+    // paths[0] is the shortest route again
+    for (size_t k = 1; k < paths.size(); ++k) {
+        trace(from, to, paths[k], pts, names);
+        cout<<"Alternative "<<k<<":"<<endl;
+        print(pts, names);
+        cout<<"Total distance = "<<lengths[k] + from.offset + to.offset<<endl;
+    }
+    if (paths.size() > 1) cout<<"Vertices settled for alternatives = "<<settled<<endl;
+}
+
+// Function to answer one line of a batch
+// Parameters: c - the search context to use, line - the query "sx sy ex ey" (spaces, tabs or commas between numbers),
+// lineNo - its line number, withDirections - true to add the directions, out - the result line is appended to it.
+// Return value: false if the line is malformed, true otherwise (also when there is no path).
+// The result line is "<lineNo>\t<distance>\t<id>,<id>,...[\t<direction>;<direction>;...]", "<lineNo>\tNOPATH"
+// or "<lineNo>\tERROR\t<reason>". Blank lines and lines starting with '#' give no result line.
+// Written by: Khoi V.
+bool GraphMap::answer(SearchContext& c, const string& line, size_t lineNo, bool withDirections, string& out) {
+    const char* p = line.data();
+    const char* end = p + line.size();
+    auto blank = [](char ch) { return ch == ' ' || ch == '\t' || ch == '\r' || ch == ','; };
+    while (p < end && blank(*p)) ++p;
+    if (p == end || *p == '#') return true;
+
+    // Parse the four coordinates
+    double v[4];
+    bool parsed = true;
+    for (int k = 0; k < 4 && parsed; ++k) {
+        while (p < end && blank(*p)) ++p;
+        if (p < end && *p == '+') ++p;
+        auto [next, err] = from_chars(p, end, v[k]);
+        parsed = err == errc() && isfinite(v[k]);
+        p = next;
+    }
+    while (parsed && p < end && blank(*p)) ++p;
+    out += to_string(lineNo);
+    if (!parsed || p != end) {
+        out += "\tERROR\texpected four coordinates: sx sy ex ey\n";
+        return false;
+    }
+    if (net->numVertices() == 0) {
+        out += "\tERROR\tthe graph has no vertices\n";
+        return false;
+    }
+
+    SEARCH_STATS(QueryScope query(c.stats));
+    SEARCH_STATS(PhaseTimer snapTimer(c.stats, QueryPhase::SNAP));
+    Snap from = snap(v[0], v[1], true), to = snap(v[2], v[3], false);
+    SEARCH_STATS(snapTimer.stop());
+    vector<size_t> path;
+    vector<pair<double,double>> pts;
+    vector<string> names;
+    size_t settled;
+    double dist = route(c, from, to, path, pts, names, settled);
+    SEARCH_STATS(PhaseTimer formatTimer(c.stats, QueryPhase::FORMAT));
+    if (dist == numeric_limits<double>::infinity()) {
+        out += "\tNOPATH\n";
+        return true;
+    }
+
+    // Shortest round-trip form of the distance, then the vertex IDs
+    char buf[32];
+    out += '\t';
+    out.append(buf, to_chars(buf, buf + sizeof(buf), dist).ptr);
+    out += '\t';
+    for (size_t i = 0; i < path.size(); ++i) {
+        if (i > 0) out += ',';
+        out.append(buf, to_chars(buf, buf + sizeof(buf), net->getValue(path[i])).ptr);
+    }
+    if (withDirections) {
+        out += '\t';
+        vector<string> steps = directions(pts, names);
+        for (size_t i = 0; i < steps.size(); ++i) {
+            if (i > 0) out += ';';
+            out += steps[i];
+        }
+    }
+    out += '\n';
+    return true;
+}
+
+// Function to answer a stream of queries
+// Description: Reads the queries in blocks of lines. Every block is answered on a worker thread of a QueryExecutor,
+// each with its own search context, while this thread reads the next blocks and writes finished ones in input order,
+// so reading, searching and formatting overlap. The number of blocks in flight is bounded, and the output is
+// written a block at a time and only flushed at the end.
+// Parameters: in - the query lines, out - receives one result line per query (see answer),
+// withDirections - true to add the directions, threads - worker threads, 0 for one per hardware thread.
+// Return value: The exit status: 0 if every query was answered (with a route or NOPATH), 2 if some line was malformed,
+// 1 if reading the input or writing the output failed, or a block of queries failed as a whole (out of memory, say);
+// the answers of such a block are left out and the error is written to cerr.
+// Written by: Khoi V.
+int GraphMap::run_batch(istream& in, ostream& out, bool withDirections, size_t threads) {
+    const size_t BLOCK = 1024;
+    // A block of query lines and its answers
+    struct Block {
+        vector<string> lines;
+        size_t firstLine;
+        string output;
+        bool ok = true;
+        promise<void> done;
+    };
+
+    // Build the indexes up front; the workers only read them
+    if (net->numVertices() > 0) build_indexes();
+    QueryExecutor pool(threads);
+    deque<unique_ptr<Block>> inFlight;
+    bool ok = true, failed = false;
+    auto writeOldest = [&]() {
+        Block& b = *inFlight.front();
+        try {
+            b.done.get_future().get();
+            out.write(b.output.data(), b.output.size());
+            ok = ok && b.ok;
+        } catch (const exception& e) {
+            cerr << "Error: queries from line " << b.firstLine << " failed: " << e.what() << endl;
+            failed = true;
+        } catch (...) {
+            cerr << "Error: queries from line " << b.firstLine << " failed" << endl;
+            failed = true;
+        }
+        inFlight.pop_front();
+    };
+
+    size_t lineNo = 0;
+    string line;
+    while (true) {
+        unique_ptr<Block> b(new Block);
+        b->firstLine = lineNo + 1;
+        while (b->lines.size() < BLOCK && getline(in, line)) b->lines.push_back(line);
+        lineNo += b->lines.size();
+        if (b->lines.empty()) break;
+        Block* job = b.get();
+        job->output.reserve(job->lines.size() * (withDirections ? 256 : 64));
+        pool.submit([this, job, withDirections](SearchContext& c) {
+            // the promise is always set, so writeOldest never waits forever
+            try {
+                for (size_t i = 0; i < job->lines.size(); ++i) {
+                    try {
+                        job->ok = answer(c, job->lines[i], job->firstLine + i, withDirections, job->output) && job->ok;
+                    } catch (const exception& e) {
+                        job->output += to_string(job->firstLine + i) + "\tERROR\t" + e.what() + "\n";
+                        job->ok = false;
+                    }
+                }
+            } catch (...) {
+                // the error line could not be written (out of memory), or the error is not a std::exception
+                job->done.set_exception(current_exception());
+                return;
+            }
+            job->done.set_value();
+        });
+        inFlight.push_back(move(b));
+        // keep a few blocks per worker in flight, so memory stays bounded on endless input
+        while (inFlight.size() > 4 * pool.numThreads()) writeOldest();
+    }
+    while (!inFlight.empty()) writeOldest();
+    out.flush();
+    if (failed || in.bad() || !out) return 1;
+    return ok ? 0 : 2;
+}
+
+// Function to find everything within a budget of some start points
+// Description: Snaps every start point to the road network as the start of a route (a point part-way along an edge
+// starts at its head, after the rest of the edge), then runs the bounded search of the graph from all of them at once.
+// Parameters: starts - the (x,y) start points, budget - the largest cost to include.
+// Return value: The coordinates and cost of every vertex within budget of its nearest start, nearest first;
+// empty if no graph is loaded.
+// Written by: Khoi V.
+vector<pair<pair<double,double>, double>> GraphMap::isochrone(const vector<pair<double,double>>& starts, double budget) {
+    vector<pair<pair<double,double>, double>> out;
+    if (net == nullptr || net->numVertices() == 0) return out;
+    SEARCH_STATS(QueryScope query(ctx.stats, showStats ? &cout : nullptr));
+    SEARCH_STATS(PhaseTimer snapTimer(ctx.stats, QueryPhase::SNAP));
+    vector<pair<size_t,double>> sources;
+    for (auto &[x, y] : starts) {
+        Snap s = snap(x, y, true);
+        sources.emplace_back(s.vertex, s.offset);
+    }
+    SEARCH_STATS(snapTimer.stop());
+    SEARCH_STATS(PhaseTimer searchTimer(ctx.stats, QueryPhase::SEARCH));
+    vector<pair<size_t,double>> reached;
+    net->reachable(ctx, sources, budget, reached);
+    SEARCH_STATS(searchTimer.stop());
+    out.reserve(reached.size());
+    for (auto &[v, d] : reached) out.emplace_back(coords[v], d);
+    return out;
+}
+
+// Function to find everything within a budget of one start point
+// Parameters: x, y - the start point, budget - the largest cost to include.
+// Return value: The coordinates and cost of every vertex within budget, nearest first.
+// Written by: Khoi V.
+vector<pair<pair<double,double>, double>> GraphMap::isochrone(double x, double y, double budget) {
+    return isochrone(vector<pair<double,double>>{{x, y}}, budget);
 }
 
 // Function to quit the program
@@ -187,5 +700,5 @@ void GraphMap::find_path() {
 // Written by: Khoi V.
 void GraphMap::quit() {
     cout<<"Exiting... Thank you!"<<endl;
-    exit(0);
+    exit(report_stats(cerr) ? 0 : 1);
 }
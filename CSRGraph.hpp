@@ -0,0 +1,209 @@
+/*
+CSRGraph.hpp
+A file that contains the templated declarations for the compressed-sparse-row (CSR) graph class.
+A CSRGraph is a frozen, read-only snapshot of a DirectedGraph laid out in contiguous arrays,
+so that searches walk flat offset/target/weight arrays instead of chasing Vertex pointers.
+Vertices are addressed by dense index 0..n-1 (the position of the vertex in DirectedGraph::getVertices()).
+Edge names are kept in a separate side table, since the searches never read them.
+The in-edges of every vertex are indexed as well (reverse CSR), for searches that run backwards from a target.
+Every array is a CSRArray, which either owns its elements or views elements stored elsewhere; a GraphImage
+uses that to serve a snapshot straight from the pages of a memory-mapped binary file.
+Written by: Khoi V.
+*/
+#include <iostream>
+#include <vector>
+#include <string>
+#include <string_view> // for std::string_view
+#include <cstdint> // for uint32_t
+#include <limits> // for std::numeric_limits
+#include <stdexcept> // for std::out_of_range
+#include "Vertex.hpp"
+#include "IndexedMinPriorityQueue.hpp"
+#include "SearchContext.hpp"
+
+#pragma once
+
+using namespace std;
+
+template <typename T, typename W>
+class DirectedGraph;
+
+template <typename T>
+class GraphImage;
+
+// Limits on the routes CSRGraph::alternatives returns
+struct AlternativeLimits {
+    size_t count = 3; // most routes returned, the shortest one included
+    double maxStretch = 0.25; // an alternative is at most (1 + maxStretch) times as long as the shortest route
+    double maxOverlap = 0.75; // and shares at most this fraction of the shortest route's length with each route before it
+    double minPlateau = 0.2; // and runs along both shortest-path trees for at least this fraction of that length, so
+                             // no short detour could improve it (local optimality)
+};
+
+// A read-only array that either owns its elements (moved in from a vector)
+// or views elements owned by someone else, such as a memory-mapped file
+template <typename U>
+class CSRArray {
+    private:
+
+    vector<U> owned; // the elements, when the array owns them
+    const U* items = nullptr; // first element (owned.data() when owning)
+    size_t count = 0;
+
+    public:
+
+    // Empty array
+    CSRArray(void);
+
+    // Takes over the elements of the vector
+    CSRArray(vector<U>&& v);
+
+    // Views count elements starting at items, which must outlive the array
+    CSRArray(const U* items, size_t count);
+
+    // Copy and move keep the copy pointing at its own elements
+    CSRArray(const CSRArray<U>& a);
+
+    CSRArray(CSRArray<U>&& a);
+
+    CSRArray<U>& operator=(CSRArray<U> a);
+
+    const U& operator[](size_t i) const;
+
+    // Overwrites element i, throws std::runtime_error if the array is a view (views are read-only)
+    void set(size_t i, const U& x);
+
+    size_t size(void) const;
+
+    const U* begin(void) const;
+
+    const U* end(void) const;
+};
+
+template <typename T>
+class CSRGraph {
+    private:
+
+    CSRArray<T> values; // values[i] = value of vertex i
+    CSRArray<size_t> offsets; // out-edges of vertex i are the edge indices [offsets[i], offsets[i+1])
+    CSRArray<uint32_t> targets; // targets[e] = index of the head vertex of edge e
+    CSRArray<double> weights; // weights[e] = weight of edge e
+    CSRArray<uint32_t> nameIds; // nameIds[e] = index of the name of edge e
+    CSRArray<size_t> nameOffsets; // name k is the characters [nameOffsets[k], nameOffsets[k+1]) of nameChars
+    CSRArray<char> nameChars; // distinct edge names, each stored once, back to back
+    CSRArray<size_t> revOffsets; // in-edges of vertex i are the slots [revOffsets[i], revOffsets[i+1])
+    CSRArray<uint32_t> revSources; // revSources[k] = index of the tail vertex of the in-edge in slot k
+    CSRArray<uint32_t> revEdges; // revEdges[k] = edge index of the in-edge in slot k
+    CSRArray<uint32_t> byValue; // vertex indices sorted by value (ties by index), for find
+
+    // The binary image reader and writer fill and read the arrays directly
+    friend class GraphImage<T>;
+
+    public:
+
+    // Marks "no vertex" / "no edge" in parent arrays and lookups
+    static constexpr size_t NONE = numeric_limits<size_t>::max();
+
+    // Default constructor (empty graph)
+    CSRGraph(void);
+
+    // Builds a snapshot of the given directed graph, converting its weights to double
+    template <typename W>
+    CSRGraph(const DirectedGraph<T, W>& g);
+
+    // Accessor methods
+    size_t numVertices(void) const;
+
+    size_t numEdges(void) const;
+
+    T getValue(size_t i) const;
+
+    // Index of the vertex with the given value (the last one if several share it), throws std::out_of_range if there is none
+    size_t find(const T& value) const;
+
+    // Out-edges of vertex u are the edge indices [edgeBegin(u), edgeEnd(u))
+    size_t edgeBegin(size_t u) const;
+
+    size_t edgeEnd(size_t u) const;
+
+    size_t edgeTarget(size_t e) const;
+
+    // Tail vertex of edge e (a binary search over the offsets)
+    size_t edgeSource(size_t e) const;
+
+    double edgeWeight(size_t e) const;
+
+    // Changes the weight of edge e in place, throws std::runtime_error if the graph views a read-only image
+    // Note: Search results computed before the change (trees, hierarchies) are not updated
+    void setEdgeWeight(size_t e, double w);
+
+    // Note: The view stays valid as long as the snapshot
+    string_view edgeName(size_t e) const;
+
+    // In-edges of vertex v are the slots [inEdgeBegin(v), inEdgeEnd(v))
+    size_t inEdgeBegin(size_t v) const;
+
+    size_t inEdgeEnd(size_t v) const;
+
+    // Tail vertex and edge index of the in-edge in slot k
+    size_t inEdgeSource(size_t k) const;
+
+    size_t inEdge(size_t k) const;
+
+    // Cheapest edge from u to v, or NONE if there is no such edge
+    size_t findEdge(size_t u, size_t v) const;
+
+    // Dijkstra's algorithm for shortest paths from the source vertex; results are left in ctx.forward
+    void Dijkstra(SearchContext& ctx, size_t source) const;
+
+    // Same, copying distances and parents into the given arrays
+    void Dijkstra(size_t source, vector<double>& dist, vector<size_t>& parent) const;
+
+    // The searches below come in two forms: one taking a SearchContext, which holds all per-search state and
+    // can be reused between queries (one context per thread), and one that uses a temporary context.
+
+    // Point-to-point shortest path, stopping as soon as the target is settled
+    // Fills path with the vertex indices from source to target and returns the distance (infinity and an empty path if unreachable)
+    // If settled is given, it receives the number of vertices taken off the queue
+    double shortestPath(SearchContext& ctx, size_t source, size_t target, vector<size_t>& path, size_t* settled = nullptr) const;
+
+    double shortestPath(size_t source, size_t target, vector<size_t>& path, size_t* settled = nullptr) const;
+
+    // Same as shortestPath, but searching forward from the source and backward from the target until the two searches meet
+    double bidirectionalDijkstra(SearchContext& ctx, size_t source, size_t target, vector<size_t>& path, size_t* settled = nullptr) const;
+
+    double bidirectionalDijkstra(size_t source, size_t target, vector<size_t>& path, size_t* settled = nullptr) const;
+
+    // Same as shortestPath, but A* search guided by a heuristic h, where h(i) estimates the distance from vertex i to the target
+    // The result is exact as long as h never overestimates (is admissible)
+    template <typename Heuristic>
+    double aStar(SearchContext& ctx, size_t source, size_t target, Heuristic h, vector<size_t>& path, size_t* settled = nullptr) const;
+
+    template <typename Heuristic>
+    double aStar(size_t source, size_t target, Heuristic h, vector<size_t>& path, size_t* settled = nullptr) const;
+
+    // One-to-many distances: Dijkstra's algorithm from the source, stopping once every target is settled
+    // Writes distRow[j] = distance to goals[j] and, if predRow is given, predRow[j] = the vertex before goals[j] on its path
+    void oneToMany(SearchContext& ctx, size_t source, const vector<size_t>& goals, double* distRow, size_t* predRow = nullptr) const;
+
+    // Bounded search: Dijkstra's algorithm from several sources at once, each starting at its own distance (its
+    // (vertex, distance) pair), that never queues a vertex farther than budget
+    // Fills reached with (vertex index, distance) of every vertex within budget of its nearest source, nearest first;
+    // parents (NONE at the sources) are left in ctx.forward. The work grows with the area reached, not the graph.
+    void reachable(SearchContext& ctx, const vector<pair<size_t,double>>& sources, double budget,
+                   vector<pair<size_t,double>>& reached) const;
+
+    // Alternative routes from source to target: the shortest route, then up to limits.count - 1 routes through
+    // plateaus (stretches where the shortest-path tree of a forward search from source and that of a backward search
+    // from target agree) that keep within the limits, best first
+    // Fills paths with the vertex indices of each route and lengths with their lengths; returns the number of routes
+    // (0 if target is unreachable). Both trees are grown once, so all routes cost about two bounded searches.
+    size_t alternatives(SearchContext& ctx, size_t source, size_t target, const AlternativeLimits& limits,
+                        vector<vector<size_t>>& paths, vector<double>& lengths, size_t* settled = nullptr) const;
+
+    // Vertex indices on the path from the root of the parent tree to target
+    // Note: target is assumed reachable, i.e. its distance is finite
+    vector<size_t> route(const vector<size_t>& parent, size_t target) const;
+};
+
+#include "CSRGraph.tpp"
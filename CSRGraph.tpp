@@ -0,0 +1,910 @@
+/*
+CSRGraph.tpp
+A file that contains the implementation of the CSRGraph class methods.
+Written by: Khoi V.
+*/
+#include <iostream>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <algorithm> // for std::reverse, std::stable_sort, std::upper_bound, std::sort, std::adjacent_find, std::find
+#include <unordered_set>
+#include <tuple> // for std::tuple
+#include <stdexcept>
+#include <limits>
+#include "CSRGraph.hpp"
+
+using namespace std;
+
+// Default constructor.
+// Initializes an empty array.
+// Parameters: None.
+// Return value: None.
+template <typename U>
+CSRArray<U>::CSRArray(void) {
+}
+
+// Owning constructor.
+// Parameters: v - the elements, moved into the array.
+// Return value: None.
+template <typename U>
+CSRArray<U>::CSRArray(vector<U>&& v) : owned(move(v)), items(owned.data()), count(owned.size()) {
+}
+
+// View constructor.
+// Parameters: items - the first element, count - the number of elements.
+// Return value: None.
+// Note: The array does not own the elements; they must outlive it.
+template <typename U>
+CSRArray<U>::CSRArray(const U* items, size_t count) : items(items), count(count) {
+}
+
+// Copy constructor.
+// Copies the elements if a owns them, otherwise views the same elements.
+// Parameters: a - the array to copy.
+// Return value: None.
+template <typename U>
+CSRArray<U>::CSRArray(const CSRArray<U>& a) : owned(a.owned), items(a.owned.empty() ? a.items : owned.data()), count(a.count) {
+}
+
+// Move constructor.
+// Parameters: a - the array to move from, left empty.
+// Return value: None.
+template <typename U>
+CSRArray<U>::CSRArray(CSRArray<U>&& a) : owned(move(a.owned)), items(a.items), count(a.count) {
+    a.items = nullptr;
+    a.count = 0;
+}
+
+// Assignment operator (copy-and-swap: a is already a copy or a moved-from temporary).
+// Parameters: a - the array to assign from.
+// Return value: A reference to this array.
+template <typename U>
+CSRArray<U>& CSRArray<U>::operator=(CSRArray<U> a) {
+    owned.swap(a.owned); // swapping vectors keeps their buffers, so items stays valid
+    swap(items, a.items);
+    swap(count, a.count);
+    return *this;
+}
+
+// Element i.
+// Parameters: i - the position of the element.
+// Return value: A reference to the element.
+template <typename U>
+const U& CSRArray<U>::operator[](size_t i) const {
+    return items[i];
+}
+
+// Overwrite an element.
+// Parameters: i - the index, x - the new value.
+// Return value: None.
+// It throws std::runtime_error if the array views elements it does not own.
+template <typename U>
+void CSRArray<U>::set(size_t i, const U& x) {
+    if (owned.empty()) {
+        throw runtime_error("Cannot modify a read-only graph array");
+    }
+    owned[i] = x;
+}
+
+// Number of elements.
+// Parameters: None.
+// Return value: The number of elements.
+template <typename U>
+size_t CSRArray<U>::size(void) const {
+    return count;
+}
+
+// First element, for iteration.
+// Parameters: None.
+// Return value: A pointer to the first element.
+template <typename U>
+const U* CSRArray<U>::begin(void) const {
+    return items;
+}
+
+// One past the last element, for iteration.
+// Parameters: None.
+// Return value: A pointer one past the last element.
+template <typename U>
+const U* CSRArray<U>::end(void) const {
+    return items + count;
+}
+
+// Default constructor.
+// Initializes an empty snapshot.
+// Parameters: None.
+// Return value: None.
+template <typename T>
+CSRGraph<T>::CSRGraph(void)
+    : offsets(vector<size_t>(1, 0)), nameOffsets(vector<size_t>(1, 0)), revOffsets(vector<size_t>(1, 0)) {
+}
+
+// Snapshot constructor.
+// Lays out the vertices and edges of the given directed graph in CSR form.
+// Vertex i of the snapshot is g.getVertices()[i], and the out-edges of each vertex keep
+// the order of its adjacency list, so edge offsets[i] + k is the k-th entry of that list.
+// Edge names are copied out of NameTable::global() into the snapshot's own table, each distinct name once.
+// Parameters: g - the directed graph to snapshot.
+// Return value: None.
+template <typename T>
+template <typename W>
+CSRGraph<T>::CSRGraph(const DirectedGraph<T, W>& g) {
+    vector<Vertex<T, W>*> verts = g.getVertices();
+    size_t n = verts.size();
+    vector<T> vals;
+    vector<size_t> offs;
+    vals.reserve(n);
+    offs.reserve(n + 1);
+
+    // 1) count edges so the edge arrays are allocated once
+    size_t m = 0;
+    for (auto v : verts) {
+        m += v->getAdjacencyList().size();
+    }
+    vector<uint32_t> tgts, ids;
+    vector<double> wts;
+    tgts.reserve(m);
+    wts.reserve(m);
+    ids.reserve(m);
+
+    // 2) copy vertices and edges, numbering the names they use as we go
+    unordered_map<uint32_t, uint32_t> nameIndex; // nameIndex[ID in the name table] = index in this snapshot
+    vector<size_t> nameOffs(1, 0);
+    vector<char> chars;
+    offs.push_back(0);
+    for (size_t i = 0; i < n; ++i) {
+        vals.push_back(verts[i]->getValue());
+        for (auto &e : verts[i]->getAdjacencyList()) {
+            tgts.push_back(static_cast<uint32_t>(get<0>(e)->getIndex()));
+            wts.push_back(WeightTraits<W>::toDouble(get<1>(e)));
+            auto it = nameIndex.find(get<2>(e));
+            if (it == nameIndex.end()) {
+                it = nameIndex.emplace(get<2>(e), static_cast<uint32_t>(nameOffs.size() - 1)).first;
+                const string& name = Vertex<T, W>::edgeName(e);
+                chars.insert(chars.end(), name.begin(), name.end());
+                nameOffs.push_back(chars.size());
+            }
+            ids.push_back(it->second);
+        }
+        offs.push_back(tgts.size());
+    }
+
+    // 3) bucket the edges by head vertex to build the reverse CSR
+    vector<size_t> revOffs(n + 1, 0);
+    for (size_t e = 0; e < m; ++e) {
+        revOffs[tgts[e] + 1]++;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        revOffs[i + 1] += revOffs[i];
+    }
+    vector<uint32_t> revSrcs(m), revEs(m);
+    vector<size_t> next(revOffs.begin(), revOffs.end() - 1);
+    for (size_t u = 0; u < n; ++u) {
+        for (size_t e = offs[u]; e < offs[u + 1]; ++e) {
+            size_t k = next[tgts[e]]++;
+            revSrcs[k] = static_cast<uint32_t>(u);
+            revEs[k] = static_cast<uint32_t>(e);
+        }
+    }
+
+    // 4) sort the vertex indices by value for find
+    vector<uint32_t> sorted(n);
+    for (size_t i = 0; i < n; ++i) sorted[i] = static_cast<uint32_t>(i);
+    stable_sort(sorted.begin(), sorted.end(), [&vals](uint32_t a, uint32_t b) { return vals[a] < vals[b]; });
+
+    values = CSRArray<T>(move(vals));
+    offsets = CSRArray<size_t>(move(offs));
+    targets = CSRArray<uint32_t>(move(tgts));
+    weights = CSRArray<double>(move(wts));
+    nameIds = CSRArray<uint32_t>(move(ids));
+    nameOffsets = CSRArray<size_t>(move(nameOffs));
+    nameChars = CSRArray<char>(move(chars));
+    revOffsets = CSRArray<size_t>(move(revOffs));
+    revSources = CSRArray<uint32_t>(move(revSrcs));
+    revEdges = CSRArray<uint32_t>(move(revEs));
+    byValue = CSRArray<uint32_t>(move(sorted));
+}
+
+// Number of vertices in the snapshot.
+// Parameters: None.
+// Return value: The number of vertices.
+template <typename T>
+size_t CSRGraph<T>::numVertices(void) const {
+    return values.size();
+}
+
+// Number of edges in the snapshot.
+// Parameters: None.
+// Return value: The number of edges.
+template <typename T>
+size_t CSRGraph<T>::numEdges(void) const {
+    return targets.size();
+}
+
+// Value of vertex i.
+// Parameters: i - the vertex index.
+// Return value: The value of the vertex.
+template <typename T>
+T CSRGraph<T>::getValue(size_t i) const {
+    return values[i];
+}
+
+// Index of the vertex with the given value.
+// Binary search over the vertex indices sorted by value, so a mapped snapshot needs no hash table.
+// Parameters: value - the value to look up.
+// Return value: The index of the vertex; if several vertices have the value, the last of them.
+// It throws std::out_of_range if no vertex has that value.
+template <typename T>
+size_t CSRGraph<T>::find(const T& value) const {
+    auto it = upper_bound(byValue.begin(), byValue.end(), value,
+                          [this](const T& v, uint32_t i) { return v < values[i]; });
+    if (it == byValue.begin() || !(values[*(it - 1)] == value)) {
+        throw out_of_range("Vertex not found in the graph.");
+    }
+    return *(it - 1);
+}
+
+// First out-edge of vertex u.
+// Parameters: u - the vertex index.
+// Return value: The index of the first out-edge of u.
+template <typename T>
+size_t CSRGraph<T>::edgeBegin(size_t u) const {
+    return offsets[u];
+}
+
+// One past the last out-edge of vertex u.
+// Parameters: u - the vertex index.
+// Return value: The index one past the last out-edge of u.
+template <typename T>
+size_t CSRGraph<T>::edgeEnd(size_t u) const {
+    return offsets[u + 1];
+}
+
+// Head vertex of edge e.
+// Parameters: e - the edge index.
+// Return value: The index of the vertex edge e points to.
+template <typename T>
+size_t CSRGraph<T>::edgeTarget(size_t e) const {
+    return targets[e];
+}
+
+// Tail vertex of edge e.
+// Parameters: e - the edge index.
+// Return value: The index of the vertex edge e leaves, found by binary search in O(log n).
+template <typename T>
+size_t CSRGraph<T>::edgeSource(size_t e) const {
+    return upper_bound(offsets.begin(), offsets.end(), e) - offsets.begin() - 1;
+}
+
+// Weight of edge e.
+// Parameters: e - the edge index.
+// Return value: The weight of edge e.
+template <typename T>
+double CSRGraph<T>::edgeWeight(size_t e) const {
+    return weights[e];
+}
+
+// Change the weight of edge e.
+// Parameters: e - the edge index, w - the new weight.
+// Return value: None.
+// It throws std::runtime_error if the graph views a mapped image, which is read-only.
+template <typename T>
+void CSRGraph<T>::setEdgeWeight(size_t e, double w) {
+    weights.set(e, w);
+}
+
+// Name of edge e.
+// Parameters: e - the edge index.
+// Return value: A view of the name of edge e in the name table.
+template <typename T>
+string_view CSRGraph<T>::edgeName(size_t e) const {
+    size_t k = nameIds[e];
+    return string_view(nameChars.begin() + nameOffsets[k], nameOffsets[k + 1] - nameOffsets[k]);
+}
+
+// First in-edge slot of vertex v.
+// Parameters: v - the vertex index.
+// Return value: The first slot of the in-edges of v.
+template <typename T>
+size_t CSRGraph<T>::inEdgeBegin(size_t v) const {
+    return revOffsets[v];
+}
+
+// One past the last in-edge slot of vertex v.
+// Parameters: v - the vertex index.
+// Return value: The slot one past the last in-edge of v.
+template <typename T>
+size_t CSRGraph<T>::inEdgeEnd(size_t v) const {
+    return revOffsets[v + 1];
+}
+
+// Tail vertex of the in-edge in slot k.
+// Parameters: k - the in-edge slot.
+// Return value: The index of the vertex the in-edge comes from.
+template <typename T>
+size_t CSRGraph<T>::inEdgeSource(size_t k) const {
+    return revSources[k];
+}
+
+// Edge index of the in-edge in slot k.
+// Parameters: k - the in-edge slot.
+// Return value: The index of the edge, usable with edgeWeight and edgeName.
+template <typename T>
+size_t CSRGraph<T>::inEdge(size_t k) const {
+    return revEdges[k];
+}
+
+// Find the cheapest edge from u to v.
+// Parameters: u - the source vertex index, v - the destination vertex index.
+// Return value: The index of the cheapest edge from u to v, or NONE if there is no such edge.
+template <typename T>
+size_t CSRGraph<T>::findEdge(size_t u, size_t v) const {
+    size_t best = NONE;
+    for (size_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+        if (targets[e] == v && (best == NONE || weights[e] < weights[best])) {
+            best = e;
+        }
+    }
+    return best;
+}
+
+// Dijkstra's Algorithm
+// Description: Computes the shortest paths from the source vertex to all other vertices of the snapshot.
+// Unlike DirectedGraph::Dijkstra before it, it keeps all per-search state in the context, so the snapshot stays
+// read-only and any number of threads can search it at once, each with its own context.
+// Parameters: ctx - the search context; on return ctx.forward holds the distance, parent and visited flag of every vertex,
+// source - the index of the start vertex.
+// Return value: None.
+// Note: The function assumes that all edge weights are non-negative.
+// It throws std::out_of_range if the source index is out of range.
+template <typename T>
+void CSRGraph<T>::Dijkstra(SearchContext& ctx, size_t source) const {
+    size_t n = numVertices();
+    if (source >= n) {
+        throw out_of_range("Start vertex not found in the graph.");
+    }
+    // 1) start a new search; every vertex reads as unreached
+    SearchSpace& fw = ctx.forward;
+    fw.reset(n);
+    fw.setDistance(source, 0.0);
+
+    // 2) only reached vertices enter the queue
+    SEARCH_STATS(ctx.stats.pushes++);
+    fw.pq.insert(0.0, source);
+
+    // 3) extract-min and relax
+    // a settled vertex already has its final distance, so alt < distance never holds for it
+    while (!fw.pq.empty()) {
+        auto [du, u] = fw.pq.pop();
+        SEARCH_STATS(ctx.stats.settled++);
+        fw.setVisited(u, true);
+        SEARCH_STATS(ctx.stats.relaxed += offsets[u + 1] - offsets[u]);
+        for (size_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+            size_t v = targets[e];
+            double alt = du + weights[e];
+            if (alt < fw.getDistance(v)) {
+                fw.setDistance(v, alt);
+                fw.setParent(v, u);
+                SEARCH_STATS(fw.pq.contains(v) ? ctx.stats.decreases++ : ctx.stats.pushes++);
+                fw.pq.insertOrDecrease(alt, v);
+            }
+        }
+    }
+}
+
+// Dijkstra's Algorithm
+// Description: Same as above, copying the results out of a temporary context.
+// Parameters: source - the index of the start vertex,
+// dist - filled with dist[i] = distance from source to vertex i (infinity if unreachable),
+// parent - filled with parent[i] = predecessor of vertex i on its shortest path (NONE for the source and unreachable vertices).
+// Return value: None.
+template <typename T>
+void CSRGraph<T>::Dijkstra(size_t source, vector<double>& dist, vector<size_t>& parent) const {
+    SearchContext ctx;
+    Dijkstra(ctx, source);
+    size_t n = numVertices();
+    dist.resize(n);
+    parent.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        dist[i] = ctx.forward.getDistance(i);
+        parent[i] = ctx.forward.getParent(i);
+    }
+}
+
+// Point-to-point shortest path.
+// Description: Runs Dijkstra's algorithm from the source and stops as soon as the target is settled,
+// so only the vertices closer to the source than the target are expanded.
+// Parameters: ctx - the search context (ctx.forward holds the search tree on return),
+// source - the index of the start vertex, target - the index of the end vertex,
+// path - filled with the vertex indices from source to target (empty if the target is unreachable),
+// settled - if not null, receives the number of vertices taken off the queue.
+// Return value: The distance from source to target, or infinity if the target is unreachable.
+// It throws std::out_of_range if either index is out of range.
+template <typename T>
+double CSRGraph<T>::shortestPath(SearchContext& ctx, size_t source, size_t target, vector<size_t>& path, size_t* settled) const {
+    size_t n = numVertices();
+    if (source >= n || target >= n) {
+        throw out_of_range("Vertex not found in the graph.");
+    }
+    SearchSpace& fw = ctx.forward;
+    fw.reset(n);
+    fw.setDistance(source, 0.0);
+    SEARCH_STATS(ctx.stats.pushes++);
+    fw.pq.insert(0.0, source);
+    size_t pops = 0;
+
+    while (!fw.pq.empty()) {
+        auto [du, u] = fw.pq.pop();
+        SEARCH_STATS(ctx.stats.settled++);
+        fw.setVisited(u, true);
+        pops++;
+        // the target is settled, so its distance is final
+        if (u == target) break;
+        SEARCH_STATS(ctx.stats.relaxed += offsets[u + 1] - offsets[u]);
+        for (size_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+            size_t v = targets[e];
+            double alt = du + weights[e];
+            if (alt < fw.getDistance(v)) {
+                fw.setDistance(v, alt);
+                fw.setParent(v, u);
+                SEARCH_STATS(fw.pq.contains(v) ? ctx.stats.decreases++ : ctx.stats.pushes++);
+                fw.pq.insertOrDecrease(alt, v);
+            }
+        }
+    }
+
+    if (settled) *settled = pops;
+    path.clear();
+    double d = fw.getDistance(target);
+    if (d == numeric_limits<double>::infinity()) {
+        return d;
+    }
+    path = fw.route(target);
+    return d;
+}
+
+// Point-to-point shortest path with a temporary search context (see above).
+template <typename T>
+double CSRGraph<T>::shortestPath(size_t source, size_t target, vector<size_t>& path, size_t* settled) const {
+    SearchContext ctx;
+    return shortestPath(ctx, source, target, path, settled);
+}
+
+// Bidirectional Dijkstra's Algorithm
+// Description: Searches forward from the source over the out-edges and backward from the target over the in-edges,
+// always expanding the side whose next vertex is closer. Every edge that links the two searches gives a candidate path;
+// the search stops once the two frontiers together are at least as long as the best candidate.
+// Parameters: ctx - the search context (ctx.forward / ctx.backward hold the two search trees on return;
+// the backward parent of a vertex is its successor towards the target),
+// source - the index of the start vertex, target - the index of the end vertex,
+// path - filled with the vertex indices from source to target (empty if the target is unreachable),
+// settled - if not null, receives the number of vertices taken off both queues.
+// Return value: The distance from source to target, or infinity if the target is unreachable.
+// It throws std::out_of_range if either index is out of range.
+template <typename T>
+double CSRGraph<T>::bidirectionalDijkstra(SearchContext& ctx, size_t source, size_t target, vector<size_t>& path, size_t* settled) const {
+    size_t n = numVertices();
+    if (source >= n || target >= n) {
+        throw out_of_range("Vertex not found in the graph.");
+    }
+    const double INF = numeric_limits<double>::infinity();
+    path.clear();
+    if (source == target) {
+        if (settled) *settled = 0;
+        path.push_back(source);
+        return 0.0;
+    }
+
+    SearchSpace& fw = ctx.forward;
+    SearchSpace& bw = ctx.backward;
+    fw.reset(n);
+    bw.reset(n);
+    fw.setDistance(source, 0.0);
+    bw.setDistance(target, 0.0);
+    SEARCH_STATS(ctx.stats.pushes += 2);
+    fw.pq.insert(0.0, source);
+    bw.pq.insert(0.0, target);
+
+    double best = INF;
+    size_t meet = NONE;
+    size_t pops = 0;
+    while (!fw.pq.empty() && !bw.pq.empty()) {
+        // no path through an unsettled vertex can beat the best one found so far
+        if (fw.pq.top().first + bw.pq.top().first >= best) break;
+
+        pops++;
+        if (fw.pq.top().first <= bw.pq.top().first) {
+            auto [du, u] = fw.pq.pop();
+            SEARCH_STATS(ctx.stats.settled++);
+            fw.setVisited(u, true);
+            SEARCH_STATS(ctx.stats.relaxed += offsets[u + 1] - offsets[u]);
+            for (size_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+                size_t v = targets[e];
+                double alt = du + weights[e];
+                if (alt < fw.getDistance(v)) {
+                    fw.setDistance(v, alt);
+                    fw.setParent(v, u);
+                    SEARCH_STATS(fw.pq.contains(v) ? ctx.stats.decreases++ : ctx.stats.pushes++);
+                    fw.pq.insertOrDecrease(alt, v);
+                    if (alt + bw.getDistance(v) < best) {
+                        best = alt + bw.getDistance(v);
+                        meet = v;
+                    }
+                }
+            }
+        } else {
+            auto [dv, v] = bw.pq.pop();
+            SEARCH_STATS(ctx.stats.settled++);
+            bw.setVisited(v, true);
+            SEARCH_STATS(ctx.stats.relaxed += revOffsets[v + 1] - revOffsets[v]);
+            for (size_t k = revOffsets[v]; k < revOffsets[v + 1]; ++k) {
+                size_t u = revSources[k];
+                double alt = dv + weights[revEdges[k]];
+                if (alt < bw.getDistance(u)) {
+                    bw.setDistance(u, alt);
+                    bw.setParent(u, v);
+                    SEARCH_STATS(bw.pq.contains(u) ? ctx.stats.decreases++ : ctx.stats.pushes++);
+                    bw.pq.insertOrDecrease(alt, u);
+                    if (fw.getDistance(u) + alt < best) {
+                        best = fw.getDistance(u) + alt;
+                        meet = u;
+                    }
+                }
+            }
+        }
+    }
+
+    if (settled) *settled = pops;
+    if (meet == NONE) {
+        return INF;
+    }
+    // source ... meet from the forward tree, then meet ... target from the backward tree
+    path = fw.route(meet);
+    for (size_t cur = bw.getParent(meet); cur != NONE; cur = bw.getParent(cur)) {
+        path.push_back(cur);
+    }
+    return best;
+}
+
+// Bidirectional Dijkstra's algorithm with a temporary search context (see above).
+template <typename T>
+double CSRGraph<T>::bidirectionalDijkstra(size_t source, size_t target, vector<size_t>& path, size_t* settled) const {
+    SearchContext ctx;
+    return bidirectionalDijkstra(ctx, source, target, path, settled);
+}
+
+// A* Search
+// Description: Like shortestPath, but the queue is ordered by distance from the source plus h(vertex),
+// an estimate of the remaining distance to the target, so the search is pulled towards the target.
+// A vertex whose distance improves after it was taken off the queue is queued again, so an admissible
+// heuristic is enough for an exact result; with a consistent heuristic no vertex is taken off twice.
+// Parameters: ctx - the search context (ctx.forward holds the search tree on return),
+// source - the index of the start vertex, target - the index of the end vertex,
+// h - callable with h(i) <= distance from vertex i to the target (h(i) = 0 gives Dijkstra's algorithm),
+// path - filled with the vertex indices from source to target (empty if the target is unreachable),
+// settled - if not null, receives the number of vertices taken off the queue.
+// Return value: The distance from source to target, or infinity if the target is unreachable.
+// It throws std::out_of_range if either index is out of range.
+template <typename T>
+template <typename Heuristic>
+double CSRGraph<T>::aStar(SearchContext& ctx, size_t source, size_t target, Heuristic h, vector<size_t>& path, size_t* settled) const {
+    size_t n = numVertices();
+    if (source >= n || target >= n) {
+        throw out_of_range("Vertex not found in the graph.");
+    }
+    SearchSpace& fw = ctx.forward;
+    fw.reset(n);
+    fw.setDistance(source, 0.0);
+    SEARCH_STATS(ctx.stats.pushes++);
+    fw.pq.insert(h(source), source);
+    size_t pops = 0;
+
+    while (!fw.pq.empty()) {
+        size_t u = fw.pq.pop().second;
+        SEARCH_STATS(ctx.stats.settled++);
+        fw.setVisited(u, true);
+        pops++;
+        if (u == target) break;
+        double du = fw.getDistance(u);
+        SEARCH_STATS(ctx.stats.relaxed += offsets[u + 1] - offsets[u]);
+        for (size_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+            size_t v = targets[e];
+            double alt = du + weights[e];
+            if (alt < fw.getDistance(v)) {
+                fw.setDistance(v, alt);
+                fw.setParent(v, u);
+                SEARCH_STATS(fw.pq.contains(v) ? ctx.stats.decreases++ : ctx.stats.pushes++);
+                fw.pq.insertOrDecrease(alt + h(v), v);
+            }
+        }
+    }
+
+    if (settled) *settled = pops;
+    path.clear();
+    double d = fw.getDistance(target);
+    if (d == numeric_limits<double>::infinity()) {
+        return d;
+    }
+    path = fw.route(target);
+    return d;
+}
+
+// A* search with a temporary search context (see above).
+template <typename T>
+template <typename Heuristic>
+double CSRGraph<T>::aStar(size_t source, size_t target, Heuristic h, vector<size_t>& path, size_t* settled) const {
+    SearchContext ctx;
+    return aStar(ctx, source, target, h, path, settled);
+}
+
+// One-to-many shortest path distances.
+// Description: Runs Dijkstra's algorithm from the source and stops as soon as every goal vertex has been settled.
+// Targets are checked in list order: the search only looks at the first target not yet settled, so the
+// check costs O(1) per settled vertex and O(targets) in total.
+// Parameters: ctx - the search context (ctx.forward holds the search tree on return),
+// source - the index of the start vertex, goals - the indices of the target vertices,
+// distRow - array of goals.size() entries, filled with the distance to each target (infinity if unreachable),
+// predRow - if not null, array of goals.size() entries, filled with the vertex before each target on its
+// shortest path (NONE for the source itself and for unreachable targets).
+// Return value: None.
+// It throws std::out_of_range if any index is out of range.
+template <typename T>
+void CSRGraph<T>::oneToMany(SearchContext& ctx, size_t source, const vector<size_t>& goals, double* distRow, size_t* predRow) const {
+    size_t n = numVertices();
+    if (source >= n) {
+        throw out_of_range("Start vertex not found in the graph.");
+    }
+    for (size_t t : goals) {
+        if (t >= n) throw out_of_range("Vertex not found in the graph.");
+    }
+    SearchSpace& fw = ctx.forward;
+    fw.reset(n);
+    fw.setDistance(source, 0.0);
+    SEARCH_STATS(ctx.stats.pushes++);
+    fw.pq.insert(0.0, source);
+    size_t next = 0; // first target that may not be settled yet
+
+    while (!fw.pq.empty()) {
+        auto [du, u] = fw.pq.pop();
+        SEARCH_STATS(ctx.stats.settled++);
+        fw.setVisited(u, true);
+        while (next < goals.size() && fw.isVisited(goals[next])) next++;
+        if (next == goals.size()) break;
+        SEARCH_STATS(ctx.stats.relaxed += offsets[u + 1] - offsets[u]);
+        for (size_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+            size_t v = targets[e];
+            double alt = du + weights[e];
+            if (alt < fw.getDistance(v)) {
+                fw.setDistance(v, alt);
+                fw.setParent(v, u);
+                SEARCH_STATS(fw.pq.contains(v) ? ctx.stats.decreases++ : ctx.stats.pushes++);
+                fw.pq.insertOrDecrease(alt, v);
+            }
+        }
+    }
+
+    for (size_t j = 0; j < goals.size(); ++j) {
+        distRow[j] = fw.getDistance(goals[j]);
+        if (predRow) predRow[j] = fw.getParent(goals[j]);
+    }
+}
+
+// Bounded multi-source search.
+// Description: Seeds the queue with every source within budget at its starting distance (a vertex given twice keeps
+// the smaller one), then runs Dijkstra's algorithm, relaxing only edges that end within budget. Vertices past the
+// budget are never queued, and the context's stamped entries need no clearing, so a small area costs little on a
+// large graph.
+// Parameters: ctx - the search context; on return ctx.forward holds the distances and parents of the reached vertices,
+// sources - (vertex index, starting distance) pairs, budget - the largest distance to reach (inclusive),
+// reached - cleared and filled with (vertex index, distance) pairs in the order the vertices were settled.
+// Return value: None.
+// Note: The function assumes that all edge weights and starting distances are non-negative.
+// It throws std::out_of_range if a source index is out of range.
+template <typename T>
+void CSRGraph<T>::reachable(SearchContext& ctx, const vector<pair<size_t,double>>& sources, double budget,
+                            vector<pair<size_t,double>>& reached) const {
+    size_t n = numVertices();
+    for (auto &s : sources) {
+        if (s.first >= n) throw out_of_range("Start vertex not found in the graph.");
+    }
+    SearchSpace& fw = ctx.forward;
+    fw.reset(n);
+    reached.clear();
+    for (auto &[s, d] : sources) {
+        if (d <= budget && d < fw.getDistance(s)) {
+            fw.setDistance(s, d);
+            SEARCH_STATS(fw.pq.contains(s) ? ctx.stats.decreases++ : ctx.stats.pushes++);
+            fw.pq.insertOrDecrease(d, s);
+        }
+    }
+
+    while (!fw.pq.empty()) {
+        auto [du, u] = fw.pq.pop();
+        SEARCH_STATS(ctx.stats.settled++);
+        fw.setVisited(u, true);
+        reached.emplace_back(u, du);
+        SEARCH_STATS(ctx.stats.relaxed += offsets[u + 1] - offsets[u]);
+        for (size_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+            size_t v = targets[e];
+            double alt = du + weights[e];
+            if (alt <= budget && alt < fw.getDistance(v)) {
+                fw.setDistance(v, alt);
+                fw.setParent(v, u);
+                SEARCH_STATS(fw.pq.contains(v) ? ctx.stats.decreases++ : ctx.stats.pushes++);
+                fw.pq.insertOrDecrease(alt, v);
+            }
+        }
+    }
+}
+
+// Alternative routes via plateaus.
+// Description: 1) Searches forward from the source and backward from the target, always advancing the side with the
+// smaller key, until both have settled every vertex within (1 + maxStretch) times the shortest distance d.
+// 2) Edges on both shortest-path trees form disjoint chains, the plateaus; the route through a plateau follows the
+// forward tree to its first vertex, the plateau, and the backward tree from its last vertex. Its length is the
+// same at every vertex of the plateau, and the route is locally optimal over the plateau's length.
+// 3) Plateaus of at least minPlateau * d on routes of at most (1 + maxStretch) * d are taken in order of
+// 2 * length - plateau length; a route is kept if it visits no vertex twice and shares at most maxOverlap * d
+// with each route kept before it (the shortest route is kept first).
+// Parameters: ctx - the search context (both spaces hold the search trees on return), source - the start vertex index,
+// target - the end vertex index, limits - the number of routes and the limits they keep to,
+// paths - receives the vertex indices of each route, lengths - receives the length of each route,
+// settled - if not null, receives the number of vertices taken off the queues.
+// Return value: The number of routes found, at most limits.count.
+// It throws std::out_of_range if either vertex index is out of range, and std::invalid_argument if a limit is negative
+// or a fraction above 1.
+template <typename T>
+size_t CSRGraph<T>::alternatives(SearchContext& ctx, size_t source, size_t target, const AlternativeLimits& limits,
+                                 vector<vector<size_t>>& paths, vector<double>& lengths, size_t* settled) const {
+    size_t n = numVertices();
+    if (source >= n || target >= n) {
+        throw out_of_range("Vertex not found in the graph.");
+    }
+    if (!(limits.maxStretch >= 0.0) || !(limits.maxOverlap >= 0.0 && limits.maxOverlap <= 1.0)
+        || !(limits.minPlateau >= 0.0 && limits.minPlateau <= 1.0)) {
+        throw invalid_argument("Alternative route limits out of range");
+    }
+    const double INF = numeric_limits<double>::infinity();
+    paths.clear();
+    lengths.clear();
+    if (settled) *settled = 0;
+    if (limits.count == 0) return 0;
+    if (source == target) {
+        paths.push_back({source});
+        lengths.push_back(0.0);
+        return 1;
+    }
+
+    // 1) grow both trees past the shortest distance, up to the stretch limit
+    SearchSpace& fw = ctx.forward;
+    SearchSpace& bw = ctx.backward;
+    fw.reset(n);
+    bw.reset(n);
+    fw.setDistance(source, 0.0);
+    bw.setDistance(target, 0.0);
+    SEARCH_STATS(ctx.stats.pushes += 2);
+    fw.pq.insert(0.0, source);
+    bw.pq.insert(0.0, target);
+    double best = INF;
+    size_t meet = NONE, pops = 0;
+    vector<size_t> both; // vertices settled by both searches
+    double factor = 1.0 + limits.maxStretch;
+    while (true) {
+        bool fwOn = !fw.pq.empty() && fw.pq.top().first <= factor * best;
+        bool bwOn = !bw.pq.empty() && bw.pq.top().first <= factor * best;
+        if (!fwOn && !bwOn) break;
+        pops++;
+        SEARCH_STATS(ctx.stats.settled++);
+        if (fwOn && (!bwOn || fw.pq.top().first <= bw.pq.top().first)) {
+            auto [du, u] = fw.pq.pop();
+            fw.setVisited(u, true);
+            if (bw.isVisited(u)) both.push_back(u);
+            SEARCH_STATS(ctx.stats.relaxed += offsets[u + 1] - offsets[u]);
+            for (size_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+                size_t v = targets[e];
+                double alt = du + weights[e];
+                if (alt < fw.getDistance(v)) {
+                    fw.setDistance(v, alt);
+                    fw.setParent(v, u);
+                    SEARCH_STATS(fw.pq.contains(v) ? ctx.stats.decreases++ : ctx.stats.pushes++);
+                    fw.pq.insertOrDecrease(alt, v);
+                    if (alt + bw.getDistance(v) < best) {
+                        best = alt + bw.getDistance(v);
+                        meet = v;
+                    }
+                }
+            }
+        } else {
+            auto [dv, v] = bw.pq.pop();
+            bw.setVisited(v, true);
+            if (fw.isVisited(v)) both.push_back(v);
+            SEARCH_STATS(ctx.stats.relaxed += revOffsets[v + 1] - revOffsets[v]);
+            for (size_t k = revOffsets[v]; k < revOffsets[v + 1]; ++k) {
+                size_t u = revSources[k];
+                double alt = dv + weights[revEdges[k]];
+                if (alt < bw.getDistance(u)) {
+                    bw.setDistance(u, alt);
+                    bw.setParent(u, v);
+                    SEARCH_STATS(bw.pq.contains(u) ? ctx.stats.decreases++ : ctx.stats.pushes++);
+                    bw.pq.insertOrDecrease(alt, u);
+                    if (fw.getDistance(u) + alt < best) {
+                        best = fw.getDistance(u) + alt;
+                        meet = u;
+                    }
+                }
+            }
+        }
+    }
+    if (settled) *settled = pops;
+    if (meet == NONE) return 0;
+
+    // the route through v: the forward tree up to v, then the backward tree from v
+    auto via = [&](size_t v) {
+        vector<size_t> path = fw.route(v);
+        for (size_t cur = bw.getParent(v); cur != NONE; cur = bw.getParent(cur)) path.push_back(cur);
+        return path;
+    };
+    // edges of the kept routes, as (tail << 32 | head), and the cost of each along its route
+    vector<unordered_map<uint64_t, double>> kept;
+    auto keep = [&](vector<size_t>&& path, double length) {
+        unordered_map<uint64_t, double> edges;
+        for (size_t i = 0; i + 1 < path.size(); ++i) {
+            edges.emplace(static_cast<uint64_t>(path[i]) << 32 | path[i + 1], weights[findEdge(path[i], path[i + 1])]);
+        }
+        kept.push_back(move(edges));
+        paths.push_back(move(path));
+        lengths.push_back(length);
+    };
+    keep(via(meet), best);
+
+    // 2) find the plateaus: chains of edges u -> w with w's forward parent u and u's backward parent w
+    auto onPlateau = [&](size_t u, size_t w) {
+        return u != NONE && w != NONE && fw.isVisited(w) && bw.isVisited(w) && fw.getParent(w) == u && bw.getParent(u) == w;
+    };
+    vector<tuple<double, double, size_t>> candidates; // (score, length, first vertex of the plateau)
+    for (size_t a : both) {
+        double length = fw.getDistance(a) + bw.getDistance(a);
+        if (length > factor * best || onPlateau(fw.getParent(a), a)) continue;
+        size_t b = a;
+        while (onPlateau(b, bw.getParent(b))) b = bw.getParent(b);
+        double plateau = fw.getDistance(b) - fw.getDistance(a);
+        if (plateau >= limits.minPlateau * best) candidates.emplace_back(2.0 * length - plateau, length, a);
+    }
+    sort(candidates.begin(), candidates.end());
+
+    // 3) keep the best candidates that visit no vertex twice and overlap no kept route too much
+    vector<size_t> sorted;
+    for (auto &[score, length, a] : candidates) {
+        if (paths.size() >= limits.count) break;
+        vector<size_t> path = via(a);
+        sorted = path;
+        sort(sorted.begin(), sorted.end());
+        if (adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) continue;
+        bool distinct = std::find(paths.begin(), paths.end(), path) == paths.end();
+        for (size_t r = 0; r < kept.size() && distinct; ++r) {
+            const auto& edges = kept[r];
+            double shared = 0.0;
+            for (size_t i = 0; i + 1 < path.size(); ++i) {
+                auto it = edges.find(static_cast<uint64_t>(path[i]) << 32 | path[i + 1]);
+                if (it != edges.end()) shared += it->second;
+            }
+            distinct = shared <= limits.maxOverlap * best;
+        }
+        if (distinct) keep(move(path), length);
+    }
+    return paths.size();
+}
+
+// Rebuild a route from a parent tree.
+// Parameters: parent - the parent array filled by a search, target - the index of the last vertex of the route.
+// Return value: The vertex indices from the root of the tree to target, in order.
+template <typename T>
+vector<size_t> CSRGraph<T>::route(const vector<size_t>& parent, size_t target) const {
+    vector<size_t> out;
+    for (size_t cur = target; cur != NONE; cur = parent[cur]) {
+        out.push_back(cur);
+    }
+    reverse(out.begin(), out.end());
+    return out;
+}
@@ -0,0 +1,106 @@
+/*
+ContractionHierarchy.hpp
+A file that contains the templated declarations for the Contraction Hierarchies (CH) route planner.
+The builder contracts the vertices of a CSRGraph one at a time, in order of importance, and adds a shortcut arc
+u -> x whenever removing v would break the only shortest path u -> v -> x. Every shortcut remembers the two arcs
+it replaces, so routes found over shortcuts can be unpacked back into the vertices of the original graph.
+A query runs a bidirectional Dijkstra that only ever moves up the hierarchy (towards later contracted vertices),
+which settles a few hundred vertices even on large road networks.
+Written by: Khoi V.
+*/
+#include <iostream>
+#include <vector>
+#include <cstdint> // for uint32_t
+#include <limits> // for std::numeric_limits
+#include "CSRGraph.hpp"
+#include "IndexedMinPriorityQueue.hpp"
+#include "SearchContext.hpp"
+
+#pragma once
+
+using namespace std;
+
+template <typename T>
+class ContractionHierarchy {
+    private:
+
+    // An arc of the hierarchy: an original edge of the snapshot, or a shortcut for two consecutive arcs
+    struct Arc {
+        uint32_t from; // tail vertex
+        uint32_t to; // head vertex
+        double weight;
+        size_t edge; // edge index in the snapshot, or NONE for a shortcut
+        size_t first; // for a shortcut, the arc from -> via
+        size_t second; // for a shortcut, the arc via -> to
+    };
+
+    // An arc of the search graphs, stored with its endpoint and weight so queries do not touch the arc table
+    struct SearchArc {
+        uint32_t other; // head vertex for upward arcs, tail vertex for downward arcs
+        double weight;
+        size_t arc; // index in arcs, for unpacking
+    };
+
+    // Working state of the builder, dropped once the hierarchy is built
+    struct Workspace {
+        vector<vector<size_t>> out; // out[u] = live arcs leaving u
+        vector<vector<size_t>> in; // in[v] = live arcs entering v
+        vector<bool> contracted;
+        vector<size_t> deletedNeighbours; // deletedNeighbours[v] = number of contracted neighbours of v
+        vector<double> dist; // witness search distances, infinity outside the last search
+        vector<size_t> touched; // vertices whose dist was set by the last witness search
+        indexedMinPQ<double> pq;
+    };
+
+    vector<Arc> arcs; // every original edge kept and every shortcut added
+    vector<size_t> rank; // rank[v] = position of v in the contraction order
+    vector<size_t> upOffsets; // arcs leaving v to a higher ranked vertex are up[upOffsets[v] .. upOffsets[v+1])
+    vector<SearchArc> up;
+    vector<size_t> downOffsets; // arcs entering v from a higher ranked vertex are down[downOffsets[v] .. downOffsets[v+1])
+    vector<SearchArc> down;
+    size_t numShortcuts = 0;
+    size_t witnessLimit = 0;
+
+    // Helpers for the builder
+    void addArc(Workspace& ws, size_t u, size_t x, double w, size_t edge, size_t first, size_t second);
+    void witnessSearch(Workspace& ws, size_t source, size_t skip, double maxDist) const;
+    void findShortcuts(Workspace& ws, size_t v, vector<pair<size_t, size_t>>& shortcuts) const;
+    double priority(Workspace& ws, size_t v) const;
+    void contract(Workspace& ws, size_t v);
+
+    // True if a higher neighbour gives v a shorter distance than dv, so the search need not expand v
+    bool stalled(const SearchSpace& space, const vector<size_t>& offsets, const vector<SearchArc>& arcsIn, size_t v, double dv) const;
+
+    // Appends the original vertices along an arc, excluding its tail
+    void unpack(size_t arc, vector<size_t>& path) const;
+
+    public:
+
+    // Marks "no vertex" / "no arc"
+    static constexpr size_t NONE = numeric_limits<size_t>::max();
+
+    // Default constructor (empty hierarchy)
+    ContractionHierarchy(void);
+
+    // Builds the hierarchy for the given snapshot
+    // witnessLimit bounds the vertices settled by each witness search; a larger limit adds fewer needless shortcuts
+    ContractionHierarchy(const CSRGraph<T>& g, size_t witnessLimit = 500);
+
+    // Accessor methods
+    size_t numVertices(void) const;
+
+    size_t getNumShortcuts(void) const;
+
+    size_t getRank(size_t v) const;
+
+    // Shortest path query between two vertices of the snapshot
+    // Fills path with the unpacked vertex indices from source to target and returns the distance (infinity and an empty path if unreachable)
+    // If settled is given, it receives the number of vertices taken off both queues
+    // The context holds the per-query state and can be reused between queries (one context per thread)
+    double query(SearchContext& ctx, size_t source, size_t target, vector<size_t>& path, size_t* settled = nullptr) const;
+
+    // Same, with a temporary search context
+    double query(size_t source, size_t target, vector<size_t>& path, size_t* settled = nullptr) const;
+};
+
+#include "ContractionHierarchy.tpp"
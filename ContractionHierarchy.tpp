@@ -0,0 +1,399 @@
+/*
+ContractionHierarchy.tpp
+A file that contains the implementation of the ContractionHierarchy class methods.
+Written by: Khoi V.
+*/
+#include <iostream>
+#include <vector>
+#include <algorithm> // for std::reverse
+#include <stdexcept>
+#include <limits>
+#include "ContractionHierarchy.hpp"
+
+using namespace std;
+
+// Default constructor.
+// Initializes an empty hierarchy.
+// Parameters: None.
+// Return value: None.
+template <typename T>
+ContractionHierarchy<T>::ContractionHierarchy(void) {
+    upOffsets.push_back(0);
+    downOffsets.push_back(0);
+}
+
+// Builder.
+// Description: Contracts every vertex of the snapshot and builds the upward and downward search graphs.
+// The next vertex to contract is the one with the lowest priority (see priority). Priorities are updated lazily:
+// a popped vertex is re-evaluated and put back if it is no longer the best choice.
+// Parameters: g - the graph snapshot, witnessLimit - the most vertices a witness search may settle.
+// Return value: None.
+template <typename T>
+ContractionHierarchy<T>::ContractionHierarchy(const CSRGraph<T>& g, size_t witnessLimit) {
+    this->witnessLimit = witnessLimit;
+    size_t n = g.numVertices();
+    Workspace ws;
+    ws.out.resize(n);
+    ws.in.resize(n);
+    ws.contracted.assign(n, false);
+    ws.deletedNeighbours.assign(n, 0);
+    ws.dist.assign(n, numeric_limits<double>::infinity());
+    ws.pq.reset(n);
+
+    // 1) start from the original edges, keeping only the cheapest of parallel edges and no self-loops
+    for (size_t u = 0; u < n; ++u) {
+        for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); ++e) {
+            if (g.edgeTarget(e) != u) {
+                addArc(ws, u, g.edgeTarget(e), g.edgeWeight(e), e, NONE, NONE);
+            }
+        }
+    }
+
+    // 2) contract the vertices in order of priority
+    rank.assign(n, 0);
+    indexedMinPQ<double> order(n);
+    for (size_t v = 0; v < n; ++v) {
+        order.insert(priority(ws, v), v);
+    }
+    size_t next = 0;
+    while (!order.empty()) {
+        size_t v = order.pop().second;
+        double fresh = priority(ws, v);
+        if (!order.empty() && fresh > order.top().first) {
+            order.insert(fresh, v);
+            continue;
+        }
+        contract(ws, v);
+        rank[v] = next++;
+    }
+
+    // 3) lay out the upward arcs of every vertex (left in out[v] by contract) and its downward arcs (left in in[v])
+    upOffsets.assign(n + 1, 0);
+    downOffsets.assign(n + 1, 0);
+    for (size_t v = 0; v < n; ++v) {
+        upOffsets[v + 1] = ws.out[v].size();
+        downOffsets[v + 1] = ws.in[v].size();
+    }
+    for (size_t v = 0; v < n; ++v) {
+        upOffsets[v + 1] += upOffsets[v];
+        downOffsets[v + 1] += downOffsets[v];
+    }
+    up.resize(upOffsets[n]);
+    down.resize(downOffsets[n]);
+    for (size_t v = 0; v < n; ++v) {
+        size_t k = upOffsets[v];
+        for (size_t a : ws.out[v]) up[k++] = SearchArc{arcs[a].to, arcs[a].weight, a};
+        k = downOffsets[v];
+        for (size_t a : ws.in[v]) down[k++] = SearchArc{arcs[a].from, arcs[a].weight, a};
+    }
+}
+
+// Add an arc u -> x to the working graph.
+// Parameters: ws - the builder state, u - the tail vertex, x - the head vertex, w - the weight,
+// edge - the snapshot edge index (NONE for a shortcut), first, second - the arcs a shortcut replaces.
+// Return value: None.
+// Note: If there already is an arc u -> x, the cheaper of the two is kept.
+template <typename T>
+void ContractionHierarchy<T>::addArc(Workspace& ws, size_t u, size_t x, double w, size_t edge, size_t first, size_t second) {
+    for (size_t& a : ws.out[u]) {
+        if (arcs[a].to == x) {
+            if (arcs[a].weight <= w) return;
+            size_t old = a;
+            a = arcs.size();
+            for (size_t& b : ws.in[x]) {
+                if (b == old) b = arcs.size();
+            }
+            arcs.push_back(Arc{static_cast<uint32_t>(u), static_cast<uint32_t>(x), w, edge, first, second});
+            return;
+        }
+    }
+    ws.out[u].push_back(arcs.size());
+    ws.in[x].push_back(arcs.size());
+    arcs.push_back(Arc{static_cast<uint32_t>(u), static_cast<uint32_t>(x), w, edge, first, second});
+}
+
+// Witness search.
+// Description: Dijkstra's algorithm from source over the vertices not yet contracted, avoiding skip,
+// stopping at distance maxDist or after witnessLimit vertices are settled.
+// Parameters: ws - the builder state, source - the start vertex, skip - the vertex being contracted, maxDist - the distance bound.
+// Return value: None. ws.dist holds the distances found; vertices not reached keep infinity.
+// Note: Stopping early can only miss witnesses, which adds extra (still correct) shortcuts.
+template <typename T>
+void ContractionHierarchy<T>::witnessSearch(Workspace& ws, size_t source, size_t skip, double maxDist) const {
+    for (size_t v : ws.touched) ws.dist[v] = numeric_limits<double>::infinity();
+    ws.touched.clear();
+    ws.pq.reset(ws.dist.size());
+    ws.dist[source] = 0.0;
+    ws.touched.push_back(source);
+    ws.pq.insert(0.0, source);
+    size_t settled = 0;
+    while (!ws.pq.empty() && settled < witnessLimit) {
+        auto [du, u] = ws.pq.pop();
+        if (du > maxDist) break;
+        settled++;
+        for (size_t a : ws.out[u]) {
+            size_t x = arcs[a].to;
+            if (x == skip || ws.contracted[x]) continue;
+            double alt = du + arcs[a].weight;
+            if (alt < ws.dist[x]) {
+                if (ws.dist[x] == numeric_limits<double>::infinity()) ws.touched.push_back(x);
+                ws.dist[x] = alt;
+                ws.pq.insertOrDecrease(alt, x);
+            }
+        }
+    }
+}
+
+// Find the shortcuts needed to contract v.
+// Description: For every live arc u -> v and v -> x, a shortcut u -> x is needed unless a witness search
+// from u finds a path to x avoiding v that is no longer than the path through v.
+// Parameters: ws - the builder state, v - the vertex to contract,
+// shortcuts - filled with (arc u -> v, arc v -> x) pairs that need a shortcut.
+// Return value: None.
+template <typename T>
+void ContractionHierarchy<T>::findShortcuts(Workspace& ws, size_t v, vector<pair<size_t, size_t>>& shortcuts) const {
+    shortcuts.clear();
+    for (size_t a1 : ws.in[v]) {
+        size_t u = arcs[a1].from;
+        if (ws.contracted[u]) continue;
+        double maxOut = -1.0;
+        for (size_t a2 : ws.out[v]) {
+            size_t x = arcs[a2].to;
+            if (x != u && !ws.contracted[x]) maxOut = max(maxOut, arcs[a2].weight);
+        }
+        if (maxOut < 0) continue;
+        witnessSearch(ws, u, v, arcs[a1].weight + maxOut);
+        for (size_t a2 : ws.out[v]) {
+            size_t x = arcs[a2].to;
+            if (x == u || ws.contracted[x]) continue;
+            if (ws.dist[x] > arcs[a1].weight + arcs[a2].weight) {
+                shortcuts.push_back(make_pair(a1, a2));
+            }
+        }
+    }
+}
+
+// Priority of a vertex in the contraction order (lower is contracted first).
+// Description: The edge difference (shortcuts added minus arcs removed) keeps the hierarchy sparse,
+// and the number of contracted neighbours spreads the contraction evenly over the graph.
+// Parameters: ws - the builder state, v - the vertex.
+// Return value: The priority of v.
+template <typename T>
+double ContractionHierarchy<T>::priority(Workspace& ws, size_t v) const {
+    vector<pair<size_t, size_t>> shortcuts;
+    findShortcuts(ws, v, shortcuts);
+    size_t removed = 0;
+    for (size_t a : ws.in[v]) removed += !ws.contracted[arcs[a].from];
+    for (size_t a : ws.out[v]) removed += !ws.contracted[arcs[a].to];
+    return 2.0 * (static_cast<double>(shortcuts.size()) - static_cast<double>(removed))
+         + static_cast<double>(ws.deletedNeighbours[v]);
+}
+
+// Contract a vertex.
+// Parameters: ws - the builder state, v - the vertex to contract.
+// Return value: None.
+template <typename T>
+void ContractionHierarchy<T>::contract(Workspace& ws, size_t v) {
+    vector<pair<size_t, size_t>> shortcuts;
+    findShortcuts(ws, v, shortcuts);
+    for (auto [a1, a2] : shortcuts) {
+        size_t u = arcs[a1].from, x = arcs[a2].to;
+        double w = arcs[a1].weight + arcs[a2].weight;
+        size_t before = arcs.size();
+        addArc(ws, u, x, w, NONE, a1, a2);
+        if (arcs.size() > before) numShortcuts++;
+    }
+    // the arcs left at v now only lead to vertices contracted later, so they are final: out[v] holds the upward
+    // arcs of v and in[v] the downward arcs into v. Take them out of the neighbours' lists so later witness
+    // searches never scan arcs to contracted vertices.
+    ws.contracted[v] = true;
+    for (size_t a : ws.in[v]) {
+        size_t u = arcs[a].from;
+        ws.deletedNeighbours[u]++;
+        vector<size_t>& list = ws.out[u];
+        for (size_t k = 0; k < list.size(); ++k) {
+            if (list[k] == a) {
+                list[k] = list.back();
+                list.pop_back();
+                break;
+            }
+        }
+    }
+    for (size_t a : ws.out[v]) {
+        size_t x = arcs[a].to;
+        ws.deletedNeighbours[x]++;
+        vector<size_t>& list = ws.in[x];
+        for (size_t k = 0; k < list.size(); ++k) {
+            if (list[k] == a) {
+                list[k] = list.back();
+                list.pop_back();
+                break;
+            }
+        }
+    }
+}
+
+// Number of vertices in the hierarchy.
+// Parameters: None.
+// Return value: The number of vertices.
+template <typename T>
+size_t ContractionHierarchy<T>::numVertices(void) const {
+    return rank.size();
+}
+
+// Number of shortcuts added by the builder.
+// Parameters: None.
+// Return value: The number of shortcuts.
+template <typename T>
+size_t ContractionHierarchy<T>::getNumShortcuts(void) const {
+    return numShortcuts;
+}
+
+// Position of a vertex in the contraction order.
+// Parameters: v - the vertex index.
+// Return value: The rank of v (0 for the first contracted vertex).
+template <typename T>
+size_t ContractionHierarchy<T>::getRank(size_t v) const {
+    return rank[v];
+}
+
+// Unpack an arc into original vertices.
+// Parameters: arc - the arc to unpack, path - the vertices to append to.
+// Return value: None. The vertices after the tail of the arc, up to and including its head, are appended to path.
+template <typename T>
+void ContractionHierarchy<T>::unpack(size_t arc, vector<size_t>& path) const {
+    vector<size_t> stack;
+    stack.push_back(arc);
+    while (!stack.empty()) {
+        size_t a = stack.back();
+        stack.pop_back();
+        if (arcs[a].edge != NONE) {
+            path.push_back(arcs[a].to);
+        } else {
+            stack.push_back(arcs[a].second);
+            stack.push_back(arcs[a].first);
+        }
+    }
+}
+
+// Stall-on-demand test.
+// Description: A vertex reached by an upward search may have a shorter path that goes up past it and comes back down,
+// which the upward search can never find. If some higher neighbour w already offers a shorter path into v, v is not
+// on a shortest up-down path and need not be expanded.
+// Parameters: space - the state of the search, offsets, arcsIn - the arcs into v from higher vertices for this
+// search direction (downward arcs for the forward search, upward arcs for the backward search), v - the vertex, dv - its distance.
+// Return value: true if v can be skipped.
+template <typename T>
+bool ContractionHierarchy<T>::stalled(const SearchSpace& space, const vector<size_t>& offsets,
+                                      const vector<SearchArc>& arcsIn, size_t v, double dv) const {
+    for (size_t k = offsets[v]; k < offsets[v + 1]; ++k) {
+        if (space.getDistance(arcsIn[k].other) + arcsIn[k].weight < dv) return true;
+    }
+    return false;
+}
+
+// Contraction Hierarchies Query
+// Description: Bidirectional Dijkstra's algorithm where the forward search only follows upward arcs from the source
+// and the backward search only follows downward arcs into the target, so both climb the hierarchy. Each side stops
+// once its next vertex is no closer than the best meeting point found, and skips stalled vertices (see stalled);
+// the route is then unpacked.
+// Parameters: ctx - the search context (the parent of a vertex in either search is the arc used to reach it),
+// source - the index of the start vertex, target - the index of the end vertex,
+// path - filled with the vertex indices from source to target (empty if the target is unreachable),
+// settled - if not null, receives the number of vertices taken off both queues.
+// Return value: The distance from source to target, or infinity if the target is unreachable.
+// It throws std::out_of_range if either index is out of range.
+template <typename T>
+double ContractionHierarchy<T>::query(SearchContext& ctx, size_t source, size_t target, vector<size_t>& path, size_t* settled) const {
+    size_t n = numVertices();
+    if (source >= n || target >= n) {
+        throw out_of_range("Vertex not found in the graph.");
+    }
+    const double INF = numeric_limits<double>::infinity();
+    path.clear();
+
+    SearchSpace& fw = ctx.forward;
+    SearchSpace& bw = ctx.backward;
+    fw.reset(n);
+    bw.reset(n);
+    fw.setDistance(source, 0.0);
+    bw.setDistance(target, 0.0);
+    SEARCH_STATS(ctx.stats.pushes += 2);
+    fw.pq.insert(0.0, source);
+    bw.pq.insert(0.0, target);
+
+    double best = source == target ? 0.0 : INF;
+    size_t meet = source == target ? source : NONE;
+    size_t pops = 0;
+    while (true) {
+        bool goF = !fw.pq.empty() && fw.pq.top().first < best;
+        bool goB = !bw.pq.empty() && bw.pq.top().first < best;
+        if (!goF && !goB) break;
+        pops++;
+        if (goF && (!goB || fw.pq.top().first <= bw.pq.top().first)) {
+            auto [du, u] = fw.pq.pop();
+            SEARCH_STATS(ctx.stats.settled++);
+            if (stalled(fw, downOffsets, down, u, du)) continue;
+            SEARCH_STATS(ctx.stats.relaxed += upOffsets[u + 1] - upOffsets[u]);
+            for (size_t k = upOffsets[u]; k < upOffsets[u + 1]; ++k) {
+                size_t v = up[k].other;
+                double alt = du + up[k].weight;
+                if (alt < fw.getDistance(v)) {
+                    fw.setDistance(v, alt);
+                    fw.setParent(v, up[k].arc);
+                    SEARCH_STATS(fw.pq.contains(v) ? ctx.stats.decreases++ : ctx.stats.pushes++);
+                    fw.pq.insertOrDecrease(alt, v);
+                    if (alt + bw.getDistance(v) < best) {
+                        best = alt + bw.getDistance(v);
+                        meet = v;
+                    }
+                }
+            }
+        } else {
+            auto [dv, v] = bw.pq.pop();
+            SEARCH_STATS(ctx.stats.settled++);
+            if (stalled(bw, upOffsets, up, v, dv)) continue;
+            SEARCH_STATS(ctx.stats.relaxed += downOffsets[v + 1] - downOffsets[v]);
+            for (size_t k = downOffsets[v]; k < downOffsets[v + 1]; ++k) {
+                size_t u = down[k].other;
+                double alt = dv + down[k].weight;
+                if (alt < bw.getDistance(u)) {
+                    bw.setDistance(u, alt);
+                    bw.setParent(u, down[k].arc);
+                    SEARCH_STATS(bw.pq.contains(u) ? ctx.stats.decreases++ : ctx.stats.pushes++);
+                    bw.pq.insertOrDecrease(alt, u);
+                    if (fw.getDistance(u) + alt < best) {
+                        best = fw.getDistance(u) + alt;
+                        meet = u;
+                    }
+                }
+            }
+        }
+    }
+    if (settled) *settled = pops;
+    if (meet == NONE) {
+        return INF;
+    }
+
+    // collect the arcs source ... meet and meet ... target, then unpack them in order
+    vector<size_t> route;
+    for (size_t cur = meet; cur != source; cur = arcs[fw.getParent(cur)].from) {
+        route.push_back(fw.getParent(cur));
+    }
+    reverse(route.begin(), route.end());
+    for (size_t cur = meet; cur != target; cur = arcs[bw.getParent(cur)].to) {
+        route.push_back(bw.getParent(cur));
+    }
+    path.push_back(source);
+    for (size_t a : route) {
+        unpack(a, path);
+    }
+    return best;
+}
+
+// Contraction Hierarchies query with a temporary search context (see above).
+template <typename T>
+double ContractionHierarchy<T>::query(size_t source, size_t target, vector<size_t>& path, size_t* settled) const {
+    SearchContext ctx;
+    return query(ctx, source, target, path, settled);
+}
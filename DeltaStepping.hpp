@@ -0,0 +1,92 @@
+/*
+DeltaStepping.hpp
+A file that contains the declaration of the DeltaStepping class, a parallel one-to-all shortest-path search.
+Delta-stepping keeps the tentative distances in buckets of width delta: bucket b holds the vertices whose distance is
+in [b * delta, (b + 1) * delta). Rounds take the lowest non-empty bucket as the frontier and relax the out-edges of all
+its vertices at once, spread over the threads; a vertex whose distance drops goes into the bucket of its new distance,
+which may be the current one again (light edges) or a later one (heavy edges). When no bucket is left, every distance
+is final. Large deltas mean fewer rounds but more vertices relaxed twice; small ones the reverse.
+Each thread keeps its own buckets, so pushing needs no synchronization; the frontier of a round is the concatenation
+of the threads' copies of the bucket, handed out in chunks through an atomic cursor. A distance is lowered and its
+parent written under a per-vertex spin lock, so the two always agree. Two barriers separate the rounds.
+The distances are the same as those of Dijkstra's algorithm, bit for bit; on ties the parent may differ.
+Written by: Khoi V.
+*/
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <memory> // for std::unique_ptr
+#include <cstdint> // for uint32_t
+#include "CSRGraph.hpp"
+
+using namespace std;
+
+template <typename T>
+class DeltaStepping {
+private:
+    // Barrier for a fixed team of threads that spins (yielding) instead of sleeping, since rounds are short
+    class SpinBarrier {
+    public:
+        SpinBarrier(size_t count = 1);
+        // Blocks until all threads of the team have called it
+        void wait();
+
+    private:
+        size_t count;
+        atomic<size_t> arrived{0};
+        atomic<size_t> generation{0};
+    };
+
+    // State of one thread, on its own cache lines
+    struct alignas(64) Worker {
+        vector<vector<uint32_t>> buckets; // ring of buckets: slot b % size holds the vertices this thread moved to bucket b
+        vector<uint32_t> frontier; // this thread's share of the current round's bucket
+    };
+
+    // Number of frontier entries a thread claims at a time
+    static constexpr size_t CHUNK = 256;
+    // Most buckets a thread keeps
+    static constexpr size_t MAX_RING = size_t(1) << 24;
+
+    const CSRGraph<T>& g;
+    size_t threads;
+    unique_ptr<atomic<double>[]> distance; // tentative distances, lowered under locked
+    unique_ptr<atomic<bool>[]> locked; // per-vertex spin locks
+    size_t capacity = 0; // length of distance and locked
+    vector<Worker> workers;
+    SpinBarrier barrier;
+    atomic<size_t> lowest[2]; // lowest non-empty bucket over all threads, alternating between rounds
+    atomic<size_t> cursor{0}; // next unclaimed entry of the current frontier
+    size_t lastRounds = 0;
+
+    // Number of threads to run when asked for the given number (0 = one per hardware thread)
+    static size_t teamSize(size_t threads);
+
+    // Loop run by thread t over a ring of the given number of buckets; parent is the caller's buffer, written under the locks
+    void work(size_t t, size_t source, double delta, size_t ring, vector<size_t>& parent);
+
+public:
+    // Searches g with the given number of threads (0 = one per hardware thread)
+    // Note: g must outlive the object and stay unchanged while run is working
+    DeltaStepping(const CSRGraph<T>& g, size_t threads = 0);
+    DeltaStepping(const DeltaStepping&) = delete;
+    DeltaStepping& operator=(const DeltaStepping&) = delete;
+
+    // Distances and parents from source to every vertex: dist[v] (infinity if unreachable) and parent[v] (the vertex
+    // before v, CSRGraph<T>::NONE for the source and unreachable vertices), resized to the number of vertices
+    // delta is the bucket width (0 = defaultDelta(g)); buffers are kept, so later runs allocate little
+    void run(size_t source, vector<double>& dist, vector<size_t>& parent, double delta = 0.0);
+
+    // Bucket width that works well on road graphs: a few times the mean edge weight
+    static double defaultDelta(const CSRGraph<T>& g);
+
+    // Number of threads
+    size_t numThreads(void) const;
+
+    // Number of rounds (frontiers relaxed) of the last run
+    size_t rounds(void) const;
+};
+
+#include "DeltaStepping.tpp"
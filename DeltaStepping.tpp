@@ -0,0 +1,207 @@
+/*
+DeltaStepping.tpp
+A file that contains the implementation of the DeltaStepping class.
+Written by: Khoi V.
+*/
+#include "DeltaStepping.hpp"
+#include <algorithm> // for std::min, std::max, std::swap
+#include <cmath> // for std::isfinite
+#include <limits> // for std::numeric_limits
+#include <stdexcept> // for std::out_of_range, std::invalid_argument
+
+// Constructor
+// Parameters: count - the number of threads in the team.
+// Return value: None.
+template <typename T>
+DeltaStepping<T>::SpinBarrier::SpinBarrier(size_t count) : count(count) {
+}
+
+// Function to wait for the rest of the team
+// Description: The last thread to arrive resets the count and bumps the generation, which the others spin on.
+// Parameters: None.
+// Return value: None.
+template <typename T>
+void DeltaStepping<T>::SpinBarrier::wait() {
+    size_t gen = generation.load(memory_order_acquire);
+    if (arrived.fetch_add(1, memory_order_acq_rel) + 1 == count) {
+        arrived.store(0, memory_order_relaxed);
+        generation.fetch_add(1, memory_order_release);
+        return;
+    }
+    for (size_t spins = 0; generation.load(memory_order_acquire) == gen; ++spins) {
+        if (spins >= 64) this_thread::yield();
+    }
+}
+
+// Constructor
+// Parameters: g - the graph to search, threads - the number of threads, or 0 for one per hardware thread.
+// Return value: None.
+template <typename T>
+DeltaStepping<T>::DeltaStepping(const CSRGraph<T>& g, size_t threads)
+    : g(g), threads(teamSize(threads)), workers(this->threads), barrier(this->threads) {
+}
+
+// Function to size the thread team
+// Parameters: threads - the number asked for, 0 for one per hardware thread.
+// Return value: The number of threads to run, at least 1.
+template <typename T>
+size_t DeltaStepping<T>::teamSize(size_t threads) {
+    if (threads == 0) threads = thread::hardware_concurrency();
+    return threads == 0 ? 1 : threads;
+}
+
+// Function to pick a bucket width
+// Parameters: g - the graph.
+// Return value: Four times the mean edge weight, or 1 if the graph has no edge of positive weight.
+template <typename T>
+double DeltaStepping<T>::defaultDelta(const CSRGraph<T>& g) {
+    double sum = 0.0;
+    for (size_t e = 0; e < g.numEdges(); ++e) sum += g.edgeWeight(e);
+    return sum > 0.0 ? 4.0 * sum / g.numEdges() : 1.0;
+}
+
+// Function to get the number of threads
+// Parameters: None.
+// Return value: The number of threads.
+template <typename T>
+size_t DeltaStepping<T>::numThreads() const {
+    return threads;
+}
+
+// Function to get the number of rounds of the last run
+// Parameters: None.
+// Return value: The number of frontiers relaxed.
+template <typename T>
+size_t DeltaStepping<T>::rounds() const {
+    return lastRounds;
+}
+
+// Delta-stepping from one source
+// Description: Runs the thread team (the calling thread is one of them) and copies the distances out.
+// Parameters: source - the index of the source vertex, dist - resized and filled with the distances,
+// parent - resized and filled with the parents, delta - the bucket width, or 0 for defaultDelta(g).
+// Return value: None.
+// It throws std::out_of_range if source is not a vertex of g, and std::invalid_argument if delta is not positive
+// and finite, or so small next to the heaviest edge that the ring would need more than MAX_RING buckets.
+template <typename T>
+void DeltaStepping<T>::run(size_t source, vector<double>& dist, vector<size_t>& parent, double delta) {
+    size_t n = g.numVertices();
+    if (source >= n) throw out_of_range("Vertex index out of range");
+    if (delta == 0.0) delta = defaultDelta(g);
+    if (!(delta > 0.0) || !isfinite(delta)) throw invalid_argument("Delta must be positive and finite");
+    if (capacity < n) {
+        distance.reset(new atomic<double>[n]);
+        locked.reset(new atomic<bool>[n]);
+        capacity = n;
+    }
+    // live distances never span more than the heaviest edge past the current bucket, so the buckets form a ring
+    double heaviest = 0.0;
+    for (size_t e = 0; e < g.numEdges(); ++e) heaviest = max(heaviest, g.edgeWeight(e));
+    if (heaviest / delta > MAX_RING) throw invalid_argument("Delta too small for the edge weights");
+    size_t ring = static_cast<size_t>(heaviest / delta) + 3;
+    dist.resize(n);
+    parent.resize(n);
+    lowest[0].store(CSRGraph<T>::NONE);
+    lowest[1].store(CSRGraph<T>::NONE);
+    cursor.store(0);
+
+    vector<thread> team;
+    for (size_t t = 1; t < threads; ++t) {
+        team.emplace_back(&DeltaStepping::work, this, t, source, delta, ring, ref(parent));
+    }
+    work(0, source, delta, ring, parent);
+    for (auto &th : team) th.join();
+
+    for (size_t v = 0; v < n; ++v) dist[v] = distance[v].load(memory_order_relaxed);
+}
+
+// Loop run by every thread of the team
+// Description: Each round, every thread offers the lowest non-empty bucket it holds; the lowest of those becomes the
+// frontier, made of each thread's copy of that bucket. The threads claim chunks of the frontier and relax the
+// out-edges of the claimed vertices, pushing the vertices they improve into their own buckets.
+// Bucket b lives in slot b % ring of each thread's buckets.
+// Parameters: t - the number of the thread, source - the index of the source vertex, delta - the bucket width,
+// ring - the number of bucket slots, parent - the caller's parent buffer.
+// Return value: None.
+template <typename T>
+void DeltaStepping<T>::work(size_t t, size_t source, double delta, size_t ring, vector<size_t>& parent) {
+    const double INF = numeric_limits<double>::infinity();
+    const size_t NONE = CSRGraph<T>::NONE;
+    size_t n = g.numVertices();
+    Worker& me = workers[t];
+    me.buckets.resize(ring);
+    for (auto &b : me.buckets) b.clear();
+    me.frontier.clear();
+
+    // each thread resets its own slice of the vertices
+    for (size_t v = n * t / threads; v < n * (t + 1) / threads; ++v) {
+        distance[v].store(INF, memory_order_relaxed);
+        locked[v].store(false, memory_order_relaxed);
+        parent[v] = NONE;
+    }
+    barrier.wait();
+    if (t == 0) {
+        distance[source].store(0.0, memory_order_relaxed);
+        me.buckets[0].push_back(static_cast<uint32_t>(source));
+    }
+
+    vector<size_t> offset(threads + 1);
+    size_t current = 0, round = 0;
+    while (true) {
+        // offer the lowest bucket this thread holds
+        size_t mine = NONE;
+        for (size_t b = current; b < current + ring; ++b) {
+            if (!me.buckets[b % ring].empty()) {
+                mine = b;
+                break;
+            }
+        }
+        atomic<size_t>& next = lowest[round & 1];
+        for (size_t seen = next.load(); mine < seen && !next.compare_exchange_weak(seen, mine);) {
+        }
+        barrier.wait();
+
+        // nobody reads the old frontiers any more; take this thread's share of the new one
+        current = next.load();
+        if (current == NONE) break;
+        me.frontier.clear();
+        if (mine == current) swap(me.frontier, me.buckets[current % ring]);
+        if (t == 0) {
+            lowest[(round + 1) & 1].store(NONE);
+            cursor.store(0);
+        }
+        barrier.wait();
+
+        for (size_t w = 0; w < threads; ++w) offset[w + 1] = offset[w] + workers[w].frontier.size();
+        size_t total = offset[threads];
+        for (size_t start; (start = cursor.fetch_add(CHUNK, memory_order_relaxed)) < total;) {
+            size_t end = min(start + CHUNK, total);
+            size_t w = 0;
+            for (size_t i = start; i < end; ++i) {
+                while (offset[w + 1] <= i) ++w;
+                size_t u = workers[w].frontier[i - offset[w]];
+                double du = distance[u].load(memory_order_relaxed);
+                // settled in an earlier bucket since it was pushed here
+                if (static_cast<size_t>(du / delta) < current) continue;
+                for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); ++e) {
+                    size_t v = g.edgeTarget(e);
+                    double alt = du + g.edgeWeight(e);
+                    if (!(alt < distance[v].load(memory_order_relaxed))) continue;
+                    bool improved = false;
+                    while (locked[v].exchange(true, memory_order_acquire)) {
+                    }
+                    if (alt < distance[v].load(memory_order_relaxed)) {
+                        distance[v].store(alt, memory_order_relaxed);
+                        parent[v] = u;
+                        improved = true;
+                    }
+                    locked[v].store(false, memory_order_release);
+                    if (!improved) continue;
+                    me.buckets[static_cast<size_t>(alt / delta) % ring].push_back(static_cast<uint32_t>(v));
+                }
+            }
+        }
+        ++round;
+    }
+    if (t == 0) lastRounds = round;
+}
@@ -1,6 +1,8 @@
 /*
 DirectedGraph.hpp
 A file that contains the templated declarations for the directed graph class.
+T is the type of the vertex values and W that of the edge weights (double by default; float or a fixed-point
+integer type makes every edge smaller). Searches run on the CSR snapshot, which holds the weights as doubles.
 Written by: Khoi V.
 */
 #include <iostream>
@@ -14,16 +16,53 @@ Written by: Khoi V.
 #include <utility> // for std::pair
 #include "DoublyLinkedList.hpp"
 #include "MinPriorityQueue.hpp"
+#include "IndexedMinPriorityQueue.hpp"
+#include "CSRGraph.hpp"
+#include "SearchContext.hpp"
+#include "QueryExecutor.hpp"
+#include "GraphFile.hpp"
+#include "ShortestPathTreeCache.hpp"
+#include <mutex> // for std::mutex
+#include "Arena.hpp"
+#include "DeltaStepping.hpp"
 
 #pragma once
 
 using namespace std;
 
-template <typename T>
+template <typename T, typename W = double>
 class DirectedGraph {
     private:
 
-    vector<Vertex<T>*> vertices; // adjacency list, which is a hash table of vertices
+    // Memory of the vertices the graph creates itself (createVertex, readFromFile, copies) and of their edge lists,
+    // given back all at once when the graph is destroyed or assigned. Memory freed before then (removed vertices,
+    // edge lists that grew) is not reused; a copy of the graph holds only what is in use.
+    // Vertices added with addVertex stay on the heap.
+    Arena arena;
+
+    vector<Vertex<T, W>*> vertices; // adjacency list, which is a hash table of vertices
+
+    mutable CSRGraph<T>* frozen = nullptr; // cached CSR snapshot, rebuilt after the graph changes
+    mutable mutex frozenLock; // guards building the snapshot
+    mutable ShortestPathTreeCache trees; // shortest-path trees of recent sources on the snapshot, cleared with it
+
+    // Drop the cached snapshot and shortest-path trees
+    void invalidate(void);
+
+    // Index of v in the vertex list, throws std::runtime_error if v is not in the graph
+    size_t indexOf(Vertex<T, W>* v) const;
+
+    // Converts a path of snapshot indices into vertices
+    vector<Vertex<T, W>*> toVertices(const vector<size_t>& path) const;
+
+    // Copy of v placed in the arena (not added to the graph)
+    Vertex<T, W>* cloneVertex(const Vertex<T, W>& v);
+
+    // Destroys a vertex of the graph: one from the arena goes back to it, one from the heap is deleted
+    void release(Vertex<T, W>* v);
+
+    // Adds copies of the vertices and edges of g to this graph, which must be empty
+    void copyFrom(const DirectedGraph<T, W>& g);
 
     public:
 
@@ -31,35 +70,111 @@ class DirectedGraph {
     DirectedGraph(void);
 
     // Copy constructor
-    DirectedGraph(const DirectedGraph<T>& g);
+    DirectedGraph(const DirectedGraph<T, W>& g);
 
     // Destructor
     ~DirectedGraph(void);
 
     // Assignment operator
-    DirectedGraph<T>& operator=(const DirectedGraph<T>& g);
+    DirectedGraph<T, W>& operator=(const DirectedGraph<T, W>& g);
 
     // Add and remove vertices and edges
-    void addVertex(Vertex<T>* v);
+    // Note: The graph takes ownership of v, which must have been allocated with new
+    void addVertex(Vertex<T, W>* v);
+
+    // Create a vertex with the given value in the arena of the graph and add it; the graph owns it
+    Vertex<T, W>* createVertex(T value);
 
-    void removeVertex(Vertex<T>* v);
+    void removeVertex(Vertex<T, W>* v);
 
     // Add an edge from vertex u to vertex v with weight w and name
-    void addEdge(Vertex<T>* u, Vertex<T>* v, double w = 1.0, string name = "");
+    void addEdge(Vertex<T, W>* u, Vertex<T, W>* v, W w = W(1), string_view name = "");
 
     // Remove an edge from vertex u to vertex v
-    void removeEdge(Vertex<T>* u, Vertex<T>* v);
+    void removeEdge(Vertex<T, W>* u, Vertex<T, W>* v);
+
+    // Change the weight of the edge from u to v in O(1); the snapshot is patched and the cached shortest-path trees
+    // are repaired instead of being dropped
+    void updateEdgeWeight(Vertex<T, W>* u, Vertex<T, W>* v, W w);
+
+    // Same for a batch of (u, v, w) changes, repairing the cached trees once for the whole batch
+    void updateEdgeWeights(const vector<tuple<Vertex<T, W>*, Vertex<T, W>*, W>>& changes);
 
     // Accessor methods
-    vector<Vertex<T>*> getVertices(void) const;
+    vector<Vertex<T, W>*> getVertices(void) const;
+
+    // (head, weight, name) of every edge of v, names looked up in the name table
+    vector<tuple <Vertex<T, W>*, W, string>> getAdjacencyList(Vertex<T, W>* v) const;
 
-    vector<tuple <Vertex<T>*, double, string>> getAdjacencyList(Vertex<T>* v) const;
+    // Read-only CSR snapshot of the graph, built on first use and cached until the graph changes
+    // Note: edits made directly through Vertex::addEdge/removeEdge are not tracked
+    const CSRGraph<T>& snapshot(void) const;
 
     // Read and write graph from a file
-    DirectedGraph<T> readFromFile(const string& filename) const;
+    // Note: Uses the memory-mapped GraphFile reader; edge names have their leading whitespace removed
+    DirectedGraph<T, W> readFromFile(const string& filename) const;
 
     // Dijkstra's algorithm for shortest paths
-    DoublyLinkedList<pair<Vertex<T>*, double>> Dijkstra(Vertex<T>* startVertex) const;
+    // Note: The vertices are not written to; the search keeps its state in a SearchContext, so queries may run concurrently
+    DoublyLinkedList<pair<Vertex<T, W>*, double>> Dijkstra(Vertex<T, W>* startVertex) const;
+
+    // Same, leaving distances and parents (by vertex index) in the given context, which can be reused between queries
+    void Dijkstra(Vertex<T, W>* startVertex, SearchContext& ctx) const;
+
+    // Same, copying them into the caller's contiguous buffers: distance[i] and parent[i] (the index of the vertex
+    // before vertex i, CSRGraph<T>::NONE for the start and unreached vertices) for vertex i of getVertices()
+    // Note: Reusing the context and the buffers between queries on an unchanged graph allocates nothing
+    void Dijkstra(Vertex<T, W>* startVertex, SearchContext& ctx, vector<double>& distance, vector<size_t>& parent) const;
+
+    // Same distances from startVertex to every vertex (and a shortest-path parent for each), computed by parallel
+    // delta-stepping on the given number of threads (0 = one per hardware thread) with buckets of width delta
+    // (0 = DeltaStepping<T>::defaultDelta); worth it over Dijkstra for one-to-all searches of large graphs
+    void deltaStepping(Vertex<T, W>* startVertex, vector<double>& distance, vector<size_t>& parent,
+                       double delta = 0.0, size_t threads = 0) const;
+
+    // Isochrone: every vertex within budget of startVertex with its distance, nearest first
+    // The search stops at the budget, so its work grows with the area reached rather than the whole graph
+    vector<pair<Vertex<T, W>*, double>> isochrone(Vertex<T, W>* startVertex, double budget) const;
+
+    // Same from several start vertices: every vertex within budget of the nearest of them
+    vector<pair<Vertex<T, W>*, double>> isochrone(const vector<Vertex<T, W>*>& sources, double budget) const;
+
+    // Same, keeping the search state in the given context; a reused context lets small queries on a large graph
+    // skip the per-vertex arrays a fresh one allocates
+    vector<pair<Vertex<T, W>*, double>> isochrone(const vector<Vertex<T, W>*>& sources, double budget, SearchContext& ctx) const;
+
+    // Point-to-point shortest path from u to v, stopping once v is settled
+    // Returns the vertices on the path and its length (an empty path and infinity if v is unreachable)
+    pair<vector<Vertex<T, W>*>, double> shortestPath(Vertex<T, W>* u, Vertex<T, W>* v) const;
+
+    // Shortest path from u to v read off the cached shortest-path tree of u, which is computed (a full Dijkstra search)
+    // and cached on a miss; same result as shortestPath. Worth it when many queries share a start vertex.
+    pair<vector<Vertex<T, W>*>, double> cachedShortestPath(Vertex<T, W>* u, Vertex<T, W>* v) const;
+
+    // Memory budget of the shortest-path tree cache in bytes (0, the default, keeps no trees)
+    void setTreeCacheBudget(size_t bytes);
+
+    // The shortest-path tree cache, holding trees of the snapshot; cleared whenever the graph changes
+    ShortestPathTreeCache& treeCache(void) const;
+
+    // Bidirectional Dijkstra's algorithm from u to v, same result as shortestPath
+    pair<vector<Vertex<T, W>*>, double> bidirectionalDijkstra(Vertex<T, W>* u, Vertex<T, W>* v) const;
+
+    // Alternative routes from u to v: the shortest route, then up to limits.count - 1 others that keep to the limits
+    // on stretch, overlap and local optimality (see CSRGraph::alternatives), each as its vertices and its length
+    // All of them come from one forward and one backward search, so three cost a few times one shortest path
+    vector<pair<vector<Vertex<T, W>*>, double>> alternativeRoutes(Vertex<T, W>* u, Vertex<T, W>* v,
+                                                                 const AlternativeLimits& limits = AlternativeLimits()) const;
+
+    // Distance matrix between two vertex sets: dist[i * targets.size() + j] = distance from sources[i] to targets[j]
+    // Sources are spread over the given number of threads (0 = one per hardware thread); each search stops once
+    // every target is settled. If predecessors is given, it receives the vertex before each target on its path.
+    vector<double> distanceMatrix(const vector<Vertex<T, W>*>& sources, const vector<Vertex<T, W>*>& targets,
+                                  vector<Vertex<T, W>*>* predecessors = nullptr, size_t threads = 0) const;
+
+    // A* search from u to v guided by h, where h(x) estimates the distance from vertex x to v without overestimating it
+    template <typename Heuristic>
+    pair<vector<Vertex<T, W>*>, double> aStar(Vertex<T, W>* u, Vertex<T, W>* v, Heuristic h) const;
 
 };
 
@@ -9,6 +9,7 @@ Written by: Khoi V.
 #include <stdexcept>
 #include <fstream>
 #include <limits> // for std::numeric_limits
+#include <mutex> // for std::lock_guard
 #include "DirectedGraph.hpp"
 
 using namespace std;
@@ -17,8 +18,8 @@ using namespace std;
 // Initializes an empty directed graph.
 // Parameters: None.
 // Return value: None.
-template <typename T>
-DirectedGraph<T>::DirectedGraph(void) {
+template <typename T, typename W>
+DirectedGraph<T, W>::DirectedGraph(void) {
     
 }
 
@@ -26,35 +27,73 @@ DirectedGraph<T>::DirectedGraph(void) {
 // Creates a deep copy of the given directed graph, including all vertices and edges.
 // Parameters: g - the directed graph to copy.
 // Return value: None.
-template <typename T>
-DirectedGraph<T>::DirectedGraph(const DirectedGraph<T>&g) {
-    // 1) clone all vertices and build a remapping
-    unordered_map<Vertex<T>*,Vertex<T>*> remap;
-    remap.reserve(g.vertices.size());
-    for (auto v : g.vertices) {
-        Vertex<T>* v2 = new Vertex<T>(*v);
+// Note: The copies are placed in the arena of the new graph, whatever the originals were allocated with.
+template <typename T, typename W>
+DirectedGraph<T, W>::DirectedGraph(const DirectedGraph<T, W>&g) : trees(g.trees) {
+    copyFrom(g);
+}
+
+// Destructor.
+// Cleans up all vertices in the directed graph.
+// Parameters: None.
+// Return value: None.
+// Note: Vertices in the arena are only destroyed; their memory goes back with the arena, in a few large chunks.
+template <typename T, typename W>
+DirectedGraph<T, W>::~DirectedGraph(void) {
+    for (Vertex<T, W>* v : vertices) {
+        if (v->getMemory() == &arena) {
+            v->~Vertex<T, W>();
+        } else {
+            delete v;
+        }
+    }
+    delete frozen;
+}
+
+// Copy the vertices and edges of another graph into this one.
+// Description: 1) clones every vertex into the arena, at the same index; 2) sizes every edge list from the original,
+// then clones the edges, finding the copy of each head by its index instead of through a pointer map.
+// Parameters: g - the directed graph to copy.
+// Return value: None.
+// Note: This graph must be empty.
+template <typename T, typename W>
+void DirectedGraph<T, W>::copyFrom(const DirectedGraph<T, W>& g) {
+    size_t n = g.vertices.size();
+    vertices.reserve(n);
+    for (Vertex<T, W>* v : g.vertices) {
+        Vertex<T, W>* v2 = cloneVertex(*v);
+        v2->setIndex(vertices.size());
         vertices.push_back(v2);
-        remap[v] = v2;
     }
-    // 2) clone all edges using that map
-    for (auto v : g.vertices) {
-        Vertex<T>* v2 = remap[v];
-        for (auto &e : v->getAdjacencyList()) {
-            Vertex<T>* oldNbr = get<0>(e);
-            double       w     = get<1>(e);
-            string       name  = get<2>(e);
-            v2->addEdge(remap[oldNbr], w, name);
+    for (size_t i = 0; i < n; ++i) {
+        vertices[i]->reserveEdges(g.vertices[i]->getAdjacencyList().size(), g.vertices[i]->getIncoming().size());
+    }
+    for (size_t i = 0; i < n; ++i) {
+        for (auto &e : g.vertices[i]->getAdjacencyList()) {
+            vertices[i]->addInternedEdge(vertices[get<0>(e)->getIndex()], get<1>(e), get<2>(e));
         }
     }
 }
 
-// Destructor.
-// Cleans up all vertices in the directed graph.
-// Parameters: None.
+// Copy a vertex into the arena.
+// Parameters: v - the vertex to copy.
+// Return value: The copy, whose edge lists are also allocated from the arena.
+template <typename T, typename W>
+Vertex<T, W>* DirectedGraph<T, W>::cloneVertex(const Vertex<T, W>& v) {
+    void* slot = arena.allocate(sizeof(Vertex<T, W>), alignof(Vertex<T, W>));
+    return new (slot) Vertex<T, W>(v, &arena);
+}
+
+// Destroy a vertex of the graph.
+// Parameters: v - the vertex, already taken out of the vertex list.
 // Return value: None.
-template <typename T>
-DirectedGraph<T>::~DirectedGraph(void) {
-    for (Vertex<T>* v : vertices) {
+// Note: The memory of a vertex from the arena is only reclaimed with the whole arena.
+template <typename T, typename W>
+void DirectedGraph<T, W>::release(Vertex<T, W>* v) {
+    if (v->getMemory() == &arena) {
+        v->~Vertex<T, W>();
+        arena.deallocate(v, sizeof(Vertex<T, W>), alignof(Vertex<T, W>));
+    } else {
         delete v;
     }
 }
@@ -64,26 +103,23 @@ DirectedGraph<T>::~DirectedGraph(void) {
 // Parameters: g - the directed graph to copy.
 // Return value: A reference to the current directed graph object.
 // Note: This method uses the copy-and-swap idiom to ensure exception safety.
-template <typename T>
-DirectedGraph<T>& DirectedGraph<T>::operator=(const DirectedGraph<T>& g) {
+template <typename T, typename W>
+DirectedGraph<T, W>& DirectedGraph<T, W>::operator=(const DirectedGraph<T, W>& g) {
     if (this != &g) {
-        // clean up current
-        for (auto v : vertices) delete v;
-        vertices.clear();
-        // same two‐step copy as above
-        unordered_map<Vertex<T>*,Vertex<T>*> remap;
-        remap.reserve(g.vertices.size());
-        for (auto v : g.vertices) {
-            Vertex<T>* v2 = new Vertex<T>(*v);
-            vertices.push_back(v2);
-            remap[v] = v2;
-        }
-        for (auto v : g.vertices) {
-            Vertex<T>* v2 = remap[v];
-            for (auto &e : v->getAdjacencyList()) {
-                v2->addEdge(remap[get<0>(e)], get<1>(e), get<2>(e));
+        // clean up current, handing the whole arena back at once
+        for (auto v : vertices) {
+            if (v->getMemory() == &arena) {
+                v->~Vertex<T, W>();
+            } else {
+                delete v;
             }
         }
+        vertices.clear();
+        arena.release();
+        invalidate();
+        trees = g.trees;
+        // same copy as above
+        copyFrom(g);
     }
     return *this;
 }
@@ -91,179 +127,487 @@ DirectedGraph<T>& DirectedGraph<T>::operator=(const DirectedGraph<T>& g) {
 // Add a vertex to the directed graph.
 // Parameters: v - the vertex to add.
 // Return value: None.
-template <typename T>
-void DirectedGraph<T>::addVertex(Vertex<T>* v) {
+template <typename T, typename W>
+void DirectedGraph<T, W>::addVertex(Vertex<T, W>* v) {
+    v->setIndex(vertices.size());
     vertices.push_back(v);
+    invalidate();
+}
+
+// Create a vertex in the arena of the directed graph and add it.
+// Parameters: value - the value of the vertex.
+// Return value: The new vertex, owned by the graph (removeVertex or the destructor frees it).
+template <typename T, typename W>
+Vertex<T, W>* DirectedGraph<T, W>::createVertex(T value) {
+    void* slot = arena.allocate(sizeof(Vertex<T, W>), alignof(Vertex<T, W>));
+    Vertex<T, W>* v = new (slot) Vertex<T, W>(value, &arena);
+    addVertex(v);
+    return v;
 }
 
 // Remove a vertex from the directed graph.
 // Parameters: v - the vertex to remove.
 // Return value: None.
 // Note: This method also removes all edges to this vertex from other vertices.
+// Only the vertices with an edge to it are visited, found through its reverse adjacency.
 // It throws an exception if the vertex does not exist in the graph.
-template <typename T>
-void DirectedGraph<T>::removeVertex(Vertex<T>* v) {
-    typename std::vector<Vertex<T>*>::iterator it = vertices.begin();
-    while (it != vertices.end()) {
-        if (*it == v) {
-            delete *it;
-            it = vertices.erase(it);
-            break;
-        } else {
-            ++it;
-        }
+template <typename T, typename W>
+void DirectedGraph<T, W>::removeVertex(Vertex<T, W>* v) {
+    size_t i = indexOf(v);
+    // Remove all edges to this vertex from other vertices (one incoming entry per edge, so parallel edges go too)
+    vector<Vertex<T, W>*> tails(v->getIncoming().begin(), v->getIncoming().end());
+    for (Vertex<T, W>* u : tails) {
+        if (u != v) u->removeEdge(v);
+    }
+    // and its own edges, so no vertex keeps it in its reverse adjacency
+    while (!v->getAdjacencyList().empty()) {
+        v->removeEdge(get<0>(v->getAdjacencyList().back()));
     }
-    // Remove all edges to this vertex from other vertices
-    for (Vertex<T>* vertex : vertices) {
-        vertex->removeEdge(v);
+    release(v);
+    vertices.erase(vertices.begin() + i);
+    // shift the indices of the vertices after the removed one
+    for (; i < vertices.size(); ++i) {
+        vertices[i]->setIndex(i);
     }
+    invalidate();
 }
 
 // Add an edge from vertex u to vertex v with weight w and name.
 // Parameters: u - the source vertex, v - the destination vertex, w - the weight of the edge, name - the name of the edge.
 // Return value: None.
-template <typename T>
-void DirectedGraph<T>::addEdge(Vertex<T>* u, Vertex<T>* v, double w, string name) {
+template <typename T, typename W>
+void DirectedGraph<T, W>::addEdge(Vertex<T, W>* u, Vertex<T, W>* v, W w, string_view name) {
     u->addEdge(v, w, name);
+    invalidate();
 }
 
 // Remove an edge from vertex u to vertex v.
 // Parameters: u - the source vertex, v - the destination vertex.
 // Return value: None.
 // Note: This method throws an exception if the edge does not exist.
-template <typename T>
-void DirectedGraph<T>::removeEdge(Vertex<T>* u, Vertex<T>* v) {
+template <typename T, typename W>
+void DirectedGraph<T, W>::removeEdge(Vertex<T, W>* u, Vertex<T, W>* v) {
     // Throw an exception if edge does not exist
     if (u->getAdjacencyList().empty()) {
         throw runtime_error("Edge does not exist");
     }
     u->removeEdge(v);
+    invalidate();
+}
+
+// Change the weight of an edge.
+// Parameters: u - the source vertex, v - the destination vertex, w - the new weight.
+// Return value: None.
+// Note: The edge is found in O(1) through the edge index of u; if there are several edges from u to v, the first one
+// changes. The snapshot, if built, is patched in place and the cached shortest-path trees are repaired.
+// It throws an exception if the edge does not exist.
+template <typename T, typename W>
+void DirectedGraph<T, W>::updateEdgeWeight(Vertex<T, W>* u, Vertex<T, W>* v, W w) {
+    updateEdgeWeights({make_tuple(u, v, w)});
+}
+
+// Change the weights of several edges.
+// Description: Sets each weight in the adjacency list of its tail and in the snapshot, whose edges are laid out in
+// adjacency list order, then repairs every cached shortest-path tree once for all the changes (dynamic SSSP),
+// which only visits the vertices whose shortest paths change.
+// Parameters: changes - (u, v, w) triples: the edge from u to v gets weight w.
+// Return value: None.
+// It throws an exception if an edge does not exist, before changing anything.
+template <typename T, typename W>
+void DirectedGraph<T, W>::updateEdgeWeights(const vector<tuple<Vertex<T, W>*, Vertex<T, W>*, W>>& changes) {
+    for (auto &c : changes) {
+        indexOf(get<0>(c));
+        if (!get<0>(c)->hasEdge(get<1>(c))) {
+            throw runtime_error("Edge does not exist");
+        }
+    }
+    vector<size_t> changed;
+    changed.reserve(changes.size());
+    for (auto &c : changes) {
+        Vertex<T, W>* u = get<0>(c);
+        size_t pos = u->setEdgeWeight(get<1>(c), get<2>(c));
+        if (frozen != nullptr) {
+            size_t e = frozen->edgeBegin(u->getIndex()) + pos;
+            frozen->setEdgeWeight(e, WeightTraits<W>::toDouble(get<2>(c)));
+            changed.push_back(e);
+        }
+    }
+    // without a snapshot there are no cached trees to repair
+    if (frozen != nullptr) {
+        SearchContext ctx;
+        trees.repair(*frozen, ctx, changed);
+    }
+}
+
+// Drop the cached CSR snapshot and the shortest-path trees computed on it.
+// Parameters: None.
+// Return value: None.
+// Note: Called by every method that changes the vertices or edges of the graph.
+template <typename T, typename W>
+void DirectedGraph<T, W>::invalidate(void) {
+    delete frozen;
+    frozen = nullptr;
+    trees.clear();
+}
+
+// Read-only CSR snapshot of the directed graph.
+// Parameters: None.
+// Return value: A reference to the cached snapshot, built on first use.
+// Note: The reference stays valid until the graph is next modified. Safe to call from several threads,
+// as long as no thread modifies the graph at the same time.
+template <typename T, typename W>
+const CSRGraph<T>& DirectedGraph<T, W>::snapshot(void) const {
+    // concurrent readers may all ask for the snapshot at once, but only one of them builds it
+    lock_guard<mutex> guard(frozenLock);
+    if (frozen == nullptr) {
+        frozen = new CSRGraph<T>(*this);
+    }
+    return *frozen;
 }
 
 // Accessor method to get the list of vertices in the directed graph.
 // Parameters: None.
 // Return value: A vector of pointers to the vertices in the directed graph.
-template <typename T>
-vector<Vertex<T>*> DirectedGraph<T>::getVertices(void) const {
+template <typename T, typename W>
+vector<Vertex<T, W>*> DirectedGraph<T, W>::getVertices(void) const {
     return vertices;
 }
 
 // Accessor method to get the adjacency list of a vertex.
 // Parameters: v - the vertex whose adjacency list to retrieve.
 // Return value: A vector of tuples containing the adjacent vertices, their weights, and edge names.
-template <typename T>
-vector<tuple <Vertex<T>*, double, string>> DirectedGraph<T>::getAdjacencyList(Vertex<T>* v) const {
-    return v->getAdjacencyList();
+template <typename T, typename W>
+vector<tuple <Vertex<T, W>*, W, string>> DirectedGraph<T, W>::getAdjacencyList(Vertex<T, W>* v) const {
+    vector<tuple <Vertex<T, W>*, W, string>> out;
+    out.reserve(v->getAdjacencyList().size());
+    for (auto &e : v->getAdjacencyList()) {
+        out.emplace_back(get<0>(e), get<1>(e), Vertex<T, W>::edgeName(e));
+    }
+    return out;
 }
 
 // Read a directed graph from a file.
 // Parameters: filename - the name of the file to read from.
 // Return value: A DirectedGraph object representing the graph read from the file.
-template <typename T>
-DirectedGraph<T> DirectedGraph<T>::readFromFile(const string& filename) const {
-    ifstream file(filename);
-    if (!file.is_open()) {
-        throw runtime_error("Could not open file: " + filename);
-    }
-
-    int n, m;
-    file >> n >> m; // Read the number of vertices and edges
+// The file is parsed by GraphFile, then the vertex list and every edge list are allocated once at their final size,
+// the vertices and edge lists in the arena of the graph.
+// An edge line without a name gives an edge with an empty name; weights are converted with Vertex<T, W>::toWeight.
+// It throws std::runtime_error if the file cannot be read, and std::out_of_range if an edge uses an unknown vertex id
+// or has a weight W cannot hold (a negative weight for an unsigned W, say).
+template <typename T, typename W>
+DirectedGraph<T, W> DirectedGraph<T, W>::readFromFile(const string& filename) const {
+    GraphFile file(filename);
+    size_t n = file.ids.size();
 
-    DirectedGraph<T> graph;
+    DirectedGraph<T, W> graph;
+    graph.vertices.reserve(n);
 
-    // Read vertices and create them
-    unordered_map<size_t,Vertex<T>*> idToVertex;
+    // Create the vertices
+    unordered_map<size_t,Vertex<T, W>*> idToVertex;
     idToVertex.reserve(n);
-    for (size_t i = 0; i < n; ++i) {
-        size_t vid;
-        double x,y;
-        file >> vid >> x >> y;
-        Vertex<T>* vertex = new Vertex<T>( static_cast<T>(vid) );
-        graph.addVertex(vertex);
-        idToVertex[vid] = vertex;
+    for (size_t vid : file.ids) {
+        idToVertex[vid] = graph.createVertex(static_cast<T>(vid));
     }
 
-    // Read edges and add them to the graph
-    for (size_t i = 0; i < m; ++i) {
-        size_t uid, vid;
-        double weight;
-        file >> uid >> vid >> weight;
-        string edgeName;
-        getline(file >> ws, edgeName);
-        auto uPtr = idToVertex.at(uid);
-        auto vPtr = idToVertex.at(vid);
-        graph.addEdge(uPtr, vPtr, weight, edgeName);
+    // Size every edge list from the out- and in-degrees, then add the edges
+    vector<size_t> outDegree(n, 0), inDegree(n, 0);
+    for (const auto &e : file.edges) {
+        outDegree[idToVertex.at(e.from)->getIndex()]++;
+        inDegree[idToVertex.at(e.to)->getIndex()]++;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        graph.vertices[i]->reserveEdges(outDegree[i], inDegree[i]);
+    }
+    for (size_t k = 0; k < file.edges.size(); ++k) {
+        auto &e = file.edges[k];
+        auto uPtr = idToVertex.at(e.from);
+        auto vPtr = idToVertex.at(e.to);
+        W w;
+        try {
+            w = Vertex<T, W>::toWeight(e.weight);
+        } catch (const out_of_range& err) {
+            throw out_of_range(string(err.what()) + " in edge " + to_string(k + 1) + " of " + filename);
+        }
+        e.rest.erase(0, min(e.rest.find_first_not_of(" \t\r\n\v\f"), e.rest.size()));
+        // the new graph has no snapshot or cached trees yet, so there is nothing to invalidate
+        uPtr->addEdge(vPtr, w, e.rest);
     }
-
-    // Close the file
-    file.close();
     return graph;
 }
 
 // Dijkstra's Algorithm
 // Description: Computes the shortest paths from the start vertex to all other vertices in the directed graph using Dijkstra's algorithm.
 // It returns a list of pairs where each pair contains a vertex and its distance from the start vertex.
-// The algorithm uses a min-priority queue to efficiently find the vertex with the smallest distance.
+// The search runs on the CSR snapshot with its state in a SearchContext, so the vertices are never written to
+// and several threads can run it on the same graph at once.
 // Parameters: startVertex - the vertex from which to compute the shortest paths.
 // Return value: A DoublyLinkedList of pairs, where each pair contains a vertex and its distance from the start vertex.
-// Note: The function assumes that the graph is connected and that all edge weights are positive.
+// Note: The function assumes that all edge weights are non-negative; unreachable vertices get distance infinity.
+// The nodes of the list are allocated as one block. Query loops should use the overload filling caller buffers.
 // It throws an exception if the start vertex is not found in the graph.
-template <typename T>
-DoublyLinkedList<pair<Vertex<T>*, double>> DirectedGraph<T>::Dijkstra(Vertex<T>* startVertex) const {
-    // 1) initialize all vertices
-    for (auto v : vertices) {
-        v->setDistance(numeric_limits<double>::infinity());
-        v->setParent(nullptr);
-        v->setVisited(false);
+template <typename T, typename W>
+DoublyLinkedList<pair<Vertex<T, W>*, double>> DirectedGraph<T, W>::Dijkstra(Vertex<T, W>* startVertex) const {
+    SearchContext ctx;
+    Dijkstra(startVertex, ctx);
+    DoublyLinkedList<pair<Vertex<T, W>*, double>> out;
+    out.reserve(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        out.push_back(make_pair(vertices[i], ctx.forward.getDistance(i)));
     }
-    // find the actual start vertex in our list
-    Vertex<T>* actualStart = nullptr;
-    for (auto v : vertices) {
-        if (v == startVertex || v->getValue() == startVertex->getValue()) {
-            actualStart = v;
-            break;
+    return out;
+}
+
+// Dijkstra's Algorithm
+// Description: Same as above, leaving the results in the given context instead of building a list:
+// ctx.forward.getDistance(v->getIndex()) and ctx.forward.getParent(v->getIndex()) give the distance and parent of vertex v.
+// Parameters: startVertex - the vertex from which to compute the shortest paths, ctx - the search context to fill.
+// Return value: None.
+// It throws an exception if the start vertex is not found in the graph.
+template <typename T, typename W>
+void DirectedGraph<T, W>::Dijkstra(Vertex<T, W>* startVertex, SearchContext& ctx) const {
+    // find the actual start vertex in our list (its index points straight at it if it is ours)
+    size_t start = CSRGraph<T>::NONE;
+    size_t si = startVertex->getIndex();
+    if (si < vertices.size() && vertices[si] == startVertex) {
+        start = si;
+    }
+    for (size_t i = 0; start == CSRGraph<T>::NONE && i < vertices.size(); ++i) {
+        if (vertices[i]->getValue() == startVertex->getValue()) {
+            start = i;
         }
     }
-    if (!actualStart) {
+    if (start == CSRGraph<T>::NONE) {
         throw runtime_error("Start vertex not found in the graph.");
     }
-    actualStart->setDistance(0.0);
+    snapshot().Dijkstra(ctx, start);
+}
 
-    // 2) build min-PQ<distance, vertex>
-    minPQ<double, Vertex<T>*> pq(vertices.size());
-    for (auto v : vertices) {
-        pq.insert(v->getDistance(), v);
+// Dijkstra's Algorithm
+// Description: Same as above, then copies the distances and parents out of the context into the given buffers.
+// Parameters: startVertex - the vertex from which to compute the shortest paths, ctx - the search context to use,
+// distance - resized to the number of vertices and filled with distance[i] = distance to vertex i (infinity if
+// unreachable), parent - filled the same way with the index of the vertex before vertex i (CSRGraph<T>::NONE for the
+// start vertex and unreachable vertices).
+// Return value: None.
+// Note: Once the snapshot is built and the context and buffers have grown to the size of the graph, a query
+// allocates nothing.
+// It throws an exception if the start vertex is not found in the graph.
+template <typename T, typename W>
+void DirectedGraph<T, W>::Dijkstra(Vertex<T, W>* startVertex, SearchContext& ctx, vector<double>& distance, vector<size_t>& parent) const {
+    Dijkstra(startVertex, ctx);
+    size_t n = vertices.size();
+    distance.resize(n);
+    parent.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        distance[i] = ctx.forward.getDistance(i);
+        parent[i] = ctx.forward.getParent(i);
     }
+}
 
-    // 3) extract-min and relax
-    while (!pq.empty()) {
-        auto [du, u] = pq.pop();
-        // once the min distance is infinity, all remaining are unreachable
-        if (du == numeric_limits<double>::infinity()) break;
-        // skip stale entries or already finalized nodes
-        if (u->isVisited()) continue;
-
-        u->setVisited(true);
-        // relax each outgoing edge
-        for (auto &e : u->getAdjacencyList()) {
-            Vertex<T>* nbr = get<0>(e);
-            double      w   = get<1>(e);
-            // only relax if neighbor still in queue
-            if (!nbr->isVisited()) {
-                double alt = du + w;
-                if (alt < nbr->getDistance()) {
-                    nbr->setDistance(alt);
-                    nbr->setParent(u);
-                    pq.updateKey(alt, nbr);
-                }
-            }
+// Parallel delta-stepping from one vertex to all others
+// Parameters: startVertex - the vertex to start from,
+// distance - resized to the number of vertices and filled with distance[i] = distance to vertex i (infinity if
+// unreachable), parent - filled the same way with the index of the vertex before vertex i (CSRGraph<T>::NONE for the
+// start vertex and unreachable vertices), delta - the bucket width, or 0 for DeltaStepping<T>::defaultDelta,
+// threads - the number of threads, or 0 for one per hardware thread.
+// Return value: None.
+// Note: The distances equal those of Dijkstra; where two shortest paths tie, the parent may be another one.
+// It throws an exception if the start vertex is not found in the graph or delta is negative.
+template <typename T, typename W>
+void DirectedGraph<T, W>::deltaStepping(Vertex<T, W>* startVertex, vector<double>& distance, vector<size_t>& parent,
+                                     double delta, size_t threads) const {
+    size_t s = indexOf(startVertex);
+    DeltaStepping<T> search(snapshot(), threads);
+    search.run(s, distance, parent, delta);
+}
+
+// Isochrone from one vertex
+// Parameters: startVertex - the vertex to start from, budget - the largest distance to include.
+// Return value: The (vertex, distance) pairs of every vertex within budget of startVertex, nearest first.
+// It throws an exception if the start vertex is not found in the graph.
+template <typename T, typename W>
+vector<pair<Vertex<T, W>*, double>> DirectedGraph<T, W>::isochrone(Vertex<T, W>* startVertex, double budget) const {
+    return isochrone(vector<Vertex<T, W>*>{startVertex}, budget);
+}
+
+// Isochrone from several vertices
+// Parameters: sources - the vertices to start from, budget - the largest distance to include.
+// Return value: The (vertex, distance) pairs of every vertex within budget of its nearest source, nearest first.
+// It throws an exception if a source is not found in the graph.
+template <typename T, typename W>
+vector<pair<Vertex<T, W>*, double>> DirectedGraph<T, W>::isochrone(const vector<Vertex<T, W>*>& sources, double budget) const {
+    SearchContext ctx;
+    return isochrone(sources, budget, ctx);
+}
+
+// Isochrone from several vertices
+// Description: Runs the bounded search of the CSR snapshot from every source at distance 0.
+// Parameters: sources - the vertices to start from, budget - the largest distance to include,
+// ctx - the search context to use; on return its forward space holds the parents of the reached vertices.
+// Return value: The (vertex, distance) pairs of every vertex within budget of its nearest source, nearest first.
+// It throws an exception if a source is not found in the graph.
+template <typename T, typename W>
+vector<pair<Vertex<T, W>*, double>> DirectedGraph<T, W>::isochrone(const vector<Vertex<T, W>*>& sources, double budget,
+                                                             SearchContext& ctx) const {
+    vector<pair<size_t, double>> starts, reached;
+    for (auto v : sources) starts.emplace_back(indexOf(v), 0.0);
+    snapshot().reachable(ctx, starts, budget, reached);
+    vector<pair<Vertex<T, W>*, double>> out;
+    out.reserve(reached.size());
+    for (auto &[i, d] : reached) out.emplace_back(vertices[i], d);
+    return out;
+}
+
+// Index of a vertex in the vertex list.
+// Parameters: v - the vertex to look up.
+// Return value: The index of v, which is also its index in the CSR snapshot.
+// It throws an exception if the vertex is not in the graph.
+template <typename T, typename W>
+size_t DirectedGraph<T, W>::indexOf(Vertex<T, W>* v) const {
+    size_t i = v->getIndex();
+    if (i >= vertices.size() || vertices[i] != v) {
+        throw runtime_error("Vertex not found in the graph.");
+    }
+    return i;
+}
+
+// Convert a path of snapshot indices into vertices.
+// Parameters: path - the vertex indices.
+// Return value: The vertices with those indices, in the same order.
+template <typename T, typename W>
+vector<Vertex<T, W>*> DirectedGraph<T, W>::toVertices(const vector<size_t>& path) const {
+    vector<Vertex<T, W>*> out;
+    out.reserve(path.size());
+    for (size_t i : path) {
+        out.push_back(vertices[i]);
+    }
+    return out;
+}
+
+// Point-to-point shortest path.
+// Description: Runs Dijkstra's algorithm on the CSR snapshot from u and stops as soon as v is settled.
+// Unlike Dijkstra, it does not write distances or parents into the vertices.
+// Parameters: u - the start vertex, v - the end vertex.
+// Return value: A pair of the vertices on the shortest path from u to v and the length of that path.
+// If v is unreachable, the path is empty and the length is infinity.
+// It throws an exception if either vertex is not in the graph.
+template <typename T, typename W>
+pair<vector<Vertex<T, W>*>, double> DirectedGraph<T, W>::shortestPath(Vertex<T, W>* u, Vertex<T, W>* v) const {
+    size_t s = indexOf(u), t = indexOf(v);
+    vector<size_t> path;
+    double d = snapshot().shortestPath(s, t, path);
+    return make_pair(toVertices(path), d);
+}
+
+// Point-to-point shortest path from a cached shortest-path tree.
+// Description: Looks up the shortest-path tree of u in the tree cache, running Dijkstra's algorithm over the whole
+// snapshot on a miss, and follows the parents from v back to u.
+// Parameters: u - the start vertex, v - the end vertex.
+// Return value: A pair of the vertices on the shortest path from u to v and the length of that path.
+// If v is unreachable, the path is empty and the length is infinity.
+// It throws an exception if either vertex is not in the graph.
+template <typename T, typename W>
+pair<vector<Vertex<T, W>*>, double> DirectedGraph<T, W>::cachedShortestPath(Vertex<T, W>* u, Vertex<T, W>* v) const {
+    size_t s = indexOf(u), t = indexOf(v);
+    SearchContext ctx;
+    shared_ptr<const ShortestPathTree> tree = trees.get(snapshot(), ctx, s);
+    return make_pair(toVertices(tree->route(t)), tree->distance[t]);
+}
+
+// Set the memory budget of the shortest-path tree cache.
+// Parameters: bytes - the most memory the cached trees may use; 0 keeps no trees.
+// Return value: None.
+template <typename T, typename W>
+void DirectedGraph<T, W>::setTreeCacheBudget(size_t bytes) {
+    trees.setBudget(bytes);
+}
+
+// Accessor method to get the shortest-path tree cache.
+// Parameters: None.
+// Return value: A reference to the cache; its trees belong to snapshot(), and it is cleared whenever the graph changes.
+template <typename T, typename W>
+ShortestPathTreeCache& DirectedGraph<T, W>::treeCache(void) const {
+    return trees;
+}
+
+// Bidirectional Dijkstra's Algorithm
+// Description: Searches the CSR snapshot forward from u and backward from v until the two searches meet.
+// Parameters: u - the start vertex, v - the end vertex.
+// Return value: A pair of the vertices on the shortest path from u to v and the length of that path.
+// If v is unreachable, the path is empty and the length is infinity.
+// It throws an exception if either vertex is not in the graph.
+template <typename T, typename W>
+pair<vector<Vertex<T, W>*>, double> DirectedGraph<T, W>::bidirectionalDijkstra(Vertex<T, W>* u, Vertex<T, W>* v) const {
+    size_t s = indexOf(u), t = indexOf(v);
+    vector<size_t> path;
+    double d = snapshot().bidirectionalDijkstra(s, t, path);
+    return make_pair(toVertices(path), d);
+}
+
+// Distance Matrix
+// Description: Computes the distances from every source to every target on the CSR snapshot.
+// Each source is a separate one-to-many Dijkstra search that stops once all targets are settled,
+// and the searches run in parallel on a QueryExecutor.
+// Parameters: sources - the row vertices, targets - the column vertices,
+// predecessors - if not null, filled row-major like the result with the vertex before each target on its shortest path
+// (nullptr when the target is the source or is unreachable),
+// threads - number of worker threads, 0 for one per hardware thread.
+// Return value: The distances in row-major order: entry i * targets.size() + j is the distance from sources[i] to targets[j],
+// infinity if there is no path.
+// It throws an exception if any vertex is not in the graph.
+template <typename T, typename W>
+vector<double> DirectedGraph<T, W>::distanceMatrix(const vector<Vertex<T, W>*>& sources, const vector<Vertex<T, W>*>& targets,
+                                                vector<Vertex<T, W>*>* predecessors, size_t threads) const {
+    vector<size_t> rows, cols;
+    for (auto v : sources) rows.push_back(indexOf(v));
+    for (auto v : targets) cols.push_back(indexOf(v));
+    const CSRGraph<T>& net = snapshot();
+    // no point starting more threads than there are rows
+    if (threads == 0) threads = thread::hardware_concurrency();
+    QueryExecutor pool(max<size_t>(1, min(threads, rows.size())));
+    vector<double> dist;
+    vector<size_t> pred;
+    pool.matrix(net, rows, cols, dist, predecessors ? &pred : nullptr);
+    if (predecessors) {
+        predecessors->assign(pred.size(), nullptr);
+        for (size_t k = 0; k < pred.size(); ++k) {
+            if (pred[k] != CSRGraph<T>::NONE) (*predecessors)[k] = vertices[pred[k]];
         }
     }
+    return dist;
+}
 
-    // 4) collect distances into a list
-    DoublyLinkedList<pair<Vertex<T>*, double>> out;
-    for (auto v : vertices) {
-        out.push_back(make_pair(v, v->getDistance()));
+// Alternative routes.
+// Parameters: u - the start vertex, v - the end vertex, limits - the number of routes and the limits they keep to.
+// Return value: The routes, shortest first, each a pair of its vertices and its length; empty if v is unreachable.
+// It throws an exception if either vertex is not in the graph or a limit is out of range.
+template <typename T, typename W>
+vector<pair<vector<Vertex<T, W>*>, double>> DirectedGraph<T, W>::alternativeRoutes(Vertex<T, W>* u, Vertex<T, W>* v,
+                                                                                  const AlternativeLimits& limits) const {
+    size_t s = indexOf(u), t = indexOf(v);
+    SearchContext ctx;
+    vector<vector<size_t>> paths;
+    vector<double> lengths;
+    snapshot().alternatives(ctx, s, t, limits, paths, lengths);
+    vector<pair<vector<Vertex<T, W>*>, double>> out;
+    for (size_t k = 0; k < paths.size(); ++k) {
+        out.emplace_back(toVertices(paths[k]), lengths[k]);
     }
     return out;
+}
+
+// A* Search
+// Description: Searches the CSR snapshot from u towards v, ordering the queue by distance from u plus h(vertex).
+// Parameters: u - the start vertex, v - the end vertex,
+// h - callable taking a Vertex<T, W>* and returning an estimate of its distance to v that never overestimates.
+// Return value: A pair of the vertices on the shortest path from u to v and the length of that path.
+// If v is unreachable, the path is empty and the length is infinity.
+// It throws an exception if either vertex is not in the graph.
+template <typename T, typename W>
+template <typename Heuristic>
+pair<vector<Vertex<T, W>*>, double> DirectedGraph<T, W>::aStar(Vertex<T, W>* u, Vertex<T, W>* v, Heuristic h) const {
+    size_t s = indexOf(u), t = indexOf(v);
+    vector<size_t> path;
+    double d = snapshot().aStar(s, t, [&](size_t i) { return h(vertices[i]); }, path);
+    return make_pair(toVertices(path), d);
 }
\ No newline at end of file
@@ -4,9 +4,15 @@ This file defines a DoublyLinkedList class template for use in data structures a
 The DoublyLinkedList class represents a doubly linked list and includes methods for managing its elements.
 It includes methods for inserting, deleting, searching, and manipulating the list.
 The class also provides methods for concatenating two lists and checking for equality.
+Nodes come from a Pool: they are carved out of blocks of growing size, and the nodes of erased elements are kept for
+reuse, so a list that is cleared and refilled allocates nothing. Lists that share a pool can splice each other in O(1).
+Indexing remembers the last node it reached, so reading a list in order with operator[] costs O(1) per element.
+Only the non-const members move it, so several threads may still read the same const list at once.
 Written by: Duc T.
 */
 #include <iostream>
+#include <memory> // for std::shared_ptr
+#include <vector>
 
 #pragma once
 
@@ -32,6 +38,47 @@ class DoublyLinkedList{
         
         ~Node() {}
     };
+
+    public:
+
+    // Pool of nodes for one or more lists.
+    // Nodes are allocated in blocks (16 nodes, then twice as many each time, up to 4096) and freed nodes are chained
+    // on a free list, so steady use allocates nothing. A pool lives as long as the last list using it.
+    // Note: A pool is not thread-safe; lists that share one must not be changed from several threads at once.
+    class Pool {
+        public:
+        Pool(void) = default;
+        ~Pool(void);
+        Pool(const Pool&) = delete;
+        Pool& operator=(const Pool&) = delete;
+
+        // Makes sure at least n nodes are free, allocating one block for all that are missing.
+        void reserve(size_t n);
+
+        // Number of nodes allocated so far.
+        size_t capacity(void) const;
+
+        // Number of free nodes.
+        size_t available(void) const;
+
+        private:
+        friend class DoublyLinkedList<T>;
+
+        vector<Node*> blocks;
+        Node* freeList = nullptr; // chained through next
+        size_t freeCount = 0;
+        size_t total = 0;
+        size_t nextBlock = 16;
+
+        // Allocates a block of n nodes and adds them to the free list.
+        void grow(size_t n);
+        // Takes a free node.
+        Node* get(void);
+        // Gives back the chain first..last (linked through next) of count nodes.
+        void put(Node* first, Node* last, size_t count);
+    };
+
+    private:
     
     Node* head;
 
@@ -39,7 +86,20 @@ class DoublyLinkedList{
     
     size_t numElements;
 
-    Node* getPointer(size_t index); 
+    shared_ptr<Pool> pool; // created on first use unless given
+
+    // Last node reached by getPointer and its index, so the next lookup near it is short (nullptr when unknown)
+    Node* cursor = nullptr;
+    size_t cursorIndex = 0;
+
+    // Node at the given index, reached from the head, the tail or the cursor, whichever is closest.
+    Node* getPointer(size_t index);
+
+    // Takes a node from the pool and stores item in it.
+    Node* newNode(const T &item);
+
+    // Gives the chain first..last of count nodes back to the pool.
+    void freeNodes(Node* first, Node* last, size_t count);
 
     public:
 
@@ -49,10 +109,17 @@ class DoublyLinkedList{
     // Return value: None.
     DoublyLinkedList<T>(void);
 
+    // Pool constructor.
+    // Initializes an empty doubly linked list that takes its nodes from the given pool.
+    // Parameters: The pool, shared with other lists so they can splice each other in O(1).
+    // Return value: None.
+    explicit DoublyLinkedList<T>(const shared_ptr<Pool>& nodes);
+
     // Copy constructor.
     // Initializes a new doubly linked list as a copy of an existing one.
     // Parameters: A given doubly linked list.
     // Return value: None.
+    // The copy has a pool of its own.
     DoublyLinkedList<T>(const DoublyLinkedList<T>& list);
 
     // Assignment operator.
@@ -60,7 +127,7 @@ class DoublyLinkedList{
     // Parameters: A given doubly linked list.
     // Return value: A reference to the current doubly linked list.
     // This allows for chaining of assignment operations.
-    DoublyLinkedList<T>& operator=(DoublyLinkedList<T> rhs);
+    DoublyLinkedList<T>& operator=(const DoublyLinkedList<T>& rhs);
 
     // Destructor.
     // Cleans up the memory used by the doubly linked list.
@@ -156,6 +223,48 @@ class DoublyLinkedList{
     // Return value: True if the lists are not equal, false otherwise.
     // This is the negation of the equality operator.
     bool operator!=(const DoublyLinkedList<T> &rhs) const;
+
+    // Splice operator.
+    // Moves every element of another list to the end of this one, leaving the other list empty.
+    // Parameters: The list to take the elements from.
+    // Return value: None.
+    // Runs in O(1) if both lists share a pool or this list is empty (it then takes the pool of the other list);
+    // otherwise the elements are copied into nodes of this list's pool.
+    void splice(DoublyLinkedList<T> &list);
+
+    // Splice operator.
+    // Moves every element of another list before a given index position of this one, leaving the other list empty.
+    // Parameters: The index position and the list to take the elements from.
+    // Return value: Throws std::out_of_range if the index is out of range.
+    // Finding the position walks at most half the list; the move itself is O(1) if both lists share a pool.
+    void splice(size_t index, DoublyLinkedList<T> &list);
+
+    // Bulk append operator.
+    // Adds copies of the elements of a range at the end of the doubly linked list.
+    // Parameters: Iterators to the first and past the last element of the range.
+    // Return value: None.
+    // The nodes are taken from the pool at once, allocating at most one block.
+    template <class Iterator>
+    void append(Iterator first, Iterator last);
+
+    // Clear operator.
+    // Removes every element, giving the nodes back to the pool.
+    // Parameters: None.
+    // Return value: None.
+    // Runs in O(1) for element types that need no destructor.
+    void clear(void);
+
+    // Reserve operator.
+    // Makes sure the pool has room for a given number of further elements without allocating.
+    // Parameters: The number of elements.
+    // Return value: None.
+    void reserve(size_t n);
+
+    // Pool accessor.
+    // Returns the pool the nodes of the doubly linked list come from, creating it if the list has none yet.
+    // Parameters: None.
+    // Return value: The pool, to share with other lists.
+    shared_ptr<Pool> getPool(void);
 };
 
 #include "DoublyLinkedList.tpp"
\ No newline at end of file
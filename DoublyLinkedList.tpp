@@ -8,10 +8,95 @@ Written by: Duc T.
 #include <cstdlib>
 #include <cassert>
 #include <stdexcept>
+#include <iterator> // for std::distance
+#include <type_traits> // for std::is_trivially_destructible
 #include "DoublyLinkedList.hpp"
 
 using namespace std;
 
+// Pool destructor. This frees every block of nodes.
+// Parameter: None.
+// Return value: None.
+template <class T>
+DoublyLinkedList<T>::Pool::~Pool(void) {
+    for (Node* block : blocks) {
+        delete[] block;
+    }
+}
+
+// Pool reserve operator. This makes sure at least n nodes are free.
+// Parameter: The number of free nodes wanted.
+// Return value: None.
+template <class T>
+void DoublyLinkedList<T>::Pool::reserve(size_t n) {
+    if (freeCount < n) {
+        grow(n - freeCount);
+    }
+}
+
+// Pool capacity operator. This returns the number of nodes allocated so far.
+// Parameter: None.
+// Return value: The number of nodes in all blocks.
+template <class T>
+size_t DoublyLinkedList<T>::Pool::capacity(void) const {
+    return total;
+}
+
+// Pool available operator. This returns the number of free nodes.
+// Parameter: None.
+// Return value: The number of nodes on the free list.
+template <class T>
+size_t DoublyLinkedList<T>::Pool::available(void) const {
+    return freeCount;
+}
+
+// Pool grow operator. This allocates a block of nodes and chains them on the free list.
+// Parameter: The number of nodes in the block.
+// Return value: None.
+template <class T>
+void DoublyLinkedList<T>::Pool::grow(size_t n) {
+    // the destructor deletes only the blocks listed here, so grow the list before new[] rather than after
+    if (blocks.size() == blocks.capacity()) {
+        blocks.reserve(blocks.empty() ? 8 : 2 * blocks.size());
+    }
+    Node* block = new Node[n];
+    blocks.push_back(block);
+    for (size_t i = 0; i + 1 < n; i++) {
+        block[i].next = &block[i + 1];
+    }
+    block[n - 1].next = freeList;
+    freeList = block;
+    freeCount += n;
+    total += n;
+}
+
+// Pool get operator. This takes a node off the free list, allocating a new block if it is empty.
+// Parameter: None.
+// Return value: A node whose value is to be overwritten.
+template <class T>
+typename DoublyLinkedList<T>::Node* DoublyLinkedList<T>::Pool::get(void) {
+    if (freeList == nullptr) {
+        grow(nextBlock);
+        if (nextBlock < 4096) {
+            nextBlock *= 2;
+        }
+    }
+    Node* node = freeList;
+    freeList = node->next;
+    freeCount--;
+    return node;
+}
+
+// Pool put operator. This chains nodes on the free list.
+// Parameters: The first and last node of a chain linked through next, and the number of nodes in it.
+// Return value: None.
+template <class T>
+void DoublyLinkedList<T>::Pool::put(Node* first, Node* last, size_t count) {
+    last->next = freeList;
+    freeList = first;
+    freeCount += count;
+}
+
 // Default constructor.
 // Parameter: NONE.
 // Return value: NONE.
@@ -22,6 +107,16 @@ DoublyLinkedList<T>::DoublyLinkedList(void) {
     numElements = 0;
 }
 
+// Pool constructor.
+// Parameter: The pool to take the nodes from.
+// Return value: NONE.
+template <class T>
+DoublyLinkedList<T>::DoublyLinkedList(const shared_ptr<Pool>& nodes) : pool(nodes) {
+    head = nullptr;
+    tail = nullptr;
+    numElements = 0;
+}
+
 // Copy constructor. This copies the data from a doubly linked list to another one.
 // Parameter: A given doubly linked list.
 // Return value: NONE.
@@ -30,90 +125,112 @@ DoublyLinkedList<T>::DoublyLinkedList(const DoublyLinkedList<T>& list) {
     head = nullptr;
     tail = nullptr;
     numElements = 0;
+    reserve(list.numElements);
     // Use a pointer to trace the nodes of the list we want to copy.
     Node* current = list.head;
-    Node* lastNodeGenerated = nullptr;
-
     while (current != nullptr) {
-        Node *newNode = new Node;
-        newNode->value = current->value;
-        newNode->prev = lastNodeGenerated;
-        newNode->next = nullptr;
-
-        if (lastNodeGenerated != nullptr) {
-            lastNodeGenerated->next = newNode;
-        } else {
-            head = newNode;  // Set head for the first node
-        }
-        lastNodeGenerated = newNode;
+        push_back(current->value);
         current = current->next;
-        numElements++;
     }
-    
-    // Set tail to the last node generated.
-    tail = lastNodeGenerated;
 }
 
 // Destructor.
 // Parameter: None.
 // Return value: None.
+// The nodes go back to the pool, which frees them once no list uses it.
 template <class T>
 DoublyLinkedList<T>::~DoublyLinkedList(void) {
-    Node* current = head;
-    while (current != nullptr) {
-        Node* temp = current->next;
-        delete current;
-        current = temp;
-    }
-    // Set head and tail to nullptr to avoid dangling pointers.
-    head = nullptr;
-    tail = nullptr;
-    // Set the number of elements to 0.
-    numElements = 0;
+    clear();
 }
 
 // Assignment Operator. This assigns to a list the same list as the list being assigned.
 // Parameter: The list to be assigned.
 // Return value: A new list which is exactly the same as the list being assigned.
+// The nodes of the current list are reused for the copy before any new ones are taken from the pool.
 template <class T>
-DoublyLinkedList<T>& DoublyLinkedList<T>::operator=(DoublyLinkedList<T> rhs) {
+DoublyLinkedList<T>& DoublyLinkedList<T>::operator=(const DoublyLinkedList<T>& rhs) {
     if (this == &rhs) {
         return *this;  // Self-assignment check
     }
 
-    // Destroy the current list
+    // Overwrite the current nodes, then add or remove nodes to match the size of the new list
     Node* current = head;
-    while (current != nullptr) {
-        Node* temp = current->next;
-        delete current;
-        current = temp;
+    Node* current2 = rhs.head;
+    while (current != nullptr && current2 != nullptr) {
+        current->value = current2->value;
+        current = current->next;
+        current2 = current2->next;
     }
-    head = nullptr;
-    tail = nullptr;
-    numElements = 0;
+    while (numElements > rhs.numElements) {
+        pop_back();
+    }
+    while (current2 != nullptr) {
+        push_back(current2->value);
+        current2 = current2->next;
+    }
+    return *this;  // Allow chain assignments
+}
 
-    // Copy the new list
-    Node* current2 = rhs.head;
-    Node* lastNodeGenerated = nullptr;
+// Node operator. This takes a node from the pool and stores a value in it.
+// Parameter: The value to store.
+// Return value: The node, not linked to any other.
+template <class T>
+typename DoublyLinkedList<T>::Node* DoublyLinkedList<T>::newNode(const T &item) {
+    if (pool == nullptr) {
+        pool = make_shared<Pool>();
+    }
+    Node* node = pool->get();
+    node->value = item;
+    node->prev = nullptr;
+    node->next = nullptr;
+    return node;
+}
 
-    while (current2 != nullptr) {
-        Node* newNode = new Node;
-        newNode->value = current2->value;
-        newNode->prev = lastNodeGenerated;
-        newNode->next = nullptr;
-
-        if (lastNodeGenerated == nullptr) {
-            head = newNode;  // Set head for the new list
-        } else {
-            lastNodeGenerated->next = newNode;
+// Free operator. This gives a chain of nodes back to the pool.
+// Parameters: The first and last node of a chain linked through next, and the number of nodes in it.
+// Return value: None.
+// The values are reset first unless their type needs no destructor, so they do not hold on to resources.
+template <class T>
+void DoublyLinkedList<T>::freeNodes(Node* first, Node* last, size_t count) {
+    if (!is_trivially_destructible<T>::value) {
+        for (Node* node = first; node != last->next; node = node->next) {
+            node->value = T();
         }
+    }
+    pool->put(first, last, count);
+}
 
-        lastNodeGenerated = newNode;
-        current2 = current2->next;
-        numElements++;
+// Pointer operator. This finds the node at a given index position.
+// Parameter: The index position, which must be less than the size of the list.
+// Return value: The node at that position.
+// The walk starts from the head, the tail or the last node found, whichever is closest, so reading the list in
+// order costs O(1) per element.
+template <class T>
+typename DoublyLinkedList<T>::Node* DoublyLinkedList<T>::getPointer(size_t index) {
+    Node* ptr = head;
+    size_t at = 0;
+    size_t best = index;
+    if (numElements - 1 - index < best) {
+        ptr = tail;
+        at = numElements - 1;
+        best = numElements - 1 - index;
     }
-    tail = lastNodeGenerated;
-    return *this;  // Allow chain assignments
+    if (cursor != nullptr) {
+        size_t fromCursor = index > cursorIndex ? index - cursorIndex : cursorIndex - index;
+        if (fromCursor < best) {
+            ptr = cursor;
+            at = cursorIndex;
+        }
+    }
+    for (; at < index; at++) {
+        ptr = ptr->next;
+    }
+    for (; at > index; at--) {
+        ptr = ptr->prev;
+    }
+    cursor = ptr;
+    cursorIndex = index;
+    return ptr;
 }
 
 // Insert operator. This inserts a node with a given value at a given index position in the doubly linked list.
@@ -124,47 +241,23 @@ void DoublyLinkedList<T>::insert(const T &item, size_t index) {
     if (index > numElements) {
         throw out_of_range("Index out of range.");
     }
-
-    Node* temp = new Node;
-    temp->value = item;
-    temp->prev = nullptr;
-    temp->next = nullptr;
-
     if (index == 0) { // Inserting at the beginning.
-        temp->next = head;
-        if (head != nullptr) {
-            head->prev = temp;
-        }
-        head = temp;
-        if (numElements == 0) {
-            tail = temp;
-        }
-    } else {
-        Node* current = head;
-        for (size_t i = 0; i < index; i++) {
-            if (current == nullptr) {
-                // This should never happen because of our index check above.
-                throw runtime_error("Unexpected null pointer encountered.");
-            }
-            current = current->next;
-        }
-        // Insert temp before 'current'
-        if (current != nullptr) {
-            temp->next = current;
-            temp->prev = current->prev;
-            if (current->prev != nullptr) {
-                current->prev->next = temp;
-            }
-            current->prev = temp;
-        } else {
-            // If current is null, inserting at the end.
-            temp->prev = tail;
-            if (tail != nullptr) {
-                tail->next = temp;
-            }
-            tail = temp;
-        }
+        push_front(item);
+        return;
+    }
+    if (index == numElements) { // Inserting at the end.
+        push_back(item);
+        return;
     }
+
+    // Insert temp before 'current'
+    Node* current = getPointer(index);
+    Node* temp = newNode(item);
+    temp->next = current;
+    temp->prev = current->prev;
+    current->prev->next = temp;
+    current->prev = temp;
+    cursor = nullptr;
     numElements++;
 }
 
@@ -177,41 +270,25 @@ void DoublyLinkedList<T>::erase(size_t index) {
         throw out_of_range("Index out of range.");
     }
 
-    Node* toDelete = head;
-
     // Case 1: Deleting the head node
     if (index == 0) {
-        head = head->next;
-        if (head != nullptr) {
-            head->prev = nullptr;
-        } else {
-            tail = nullptr; // List becomes empty.
-        }
-        delete toDelete;
+        pop_front();
     }
     // Case 2: Deleting the tail node
     else if (index == numElements - 1) {
-        toDelete = tail;
-        tail = tail->prev;
-        if (tail != nullptr) {
-            tail->next = nullptr;
-        } else {
-            head = nullptr; // List becomes empty.
-        }
-        delete toDelete;
+        pop_back();
     }
     // Case 3: Deleting a middle node
     else {
-        for (size_t i = 0; i < index; i++) {
-            toDelete = toDelete->next;
-        }
+        Node* toDelete = getPointer(index);
         Node* prevToDelete = toDelete->prev;
         Node* nextToDelete = toDelete->next;
         prevToDelete->next = nextToDelete;
         nextToDelete->prev = prevToDelete;
-        delete toDelete;
+        freeNodes(toDelete, toDelete, 1);
+        cursor = nullptr;
+        numElements--;
     }
-    numElements--;
 }
 
 // Search operator. This returns the index value of the first node with value equal to 'item'.
@@ -236,9 +313,7 @@ size_t DoublyLinkedList<T>::search(const T &item) const {
 // Return value: None.
 template <class T>
 void DoublyLinkedList<T>::push_front(const T &item) {
-    Node* temp = new Node;
-    temp->value = item;
-    temp->prev = nullptr;
+    Node* temp = newNode(item);
     temp->next = head;
     if (head != nullptr) {
         head->prev = temp;
@@ -247,6 +322,7 @@ void DoublyLinkedList<T>::push_front(const T &item) {
     if (numElements == 0) {
         tail = temp;
     }
+    cursor = nullptr;
     numElements++;
 }
 
@@ -255,9 +331,7 @@ void DoublyLinkedList<T>::push_front(const T &item) {
 // Return value: None.
 template <class T>
 void DoublyLinkedList<T>::push_back(const T &item) {
-    Node* temp = new Node;
-    temp->value = item;
-    temp->next = nullptr;
+    Node* temp = newNode(item);
     temp->prev = tail;
 
     if (tail == nullptr) {
@@ -287,7 +361,8 @@ T DoublyLinkedList<T>::pop_front(void) {
     } else {
         tail = nullptr; // List becomes empty.
     }
-    delete temp;
+    freeNodes(temp, temp, 1);
+    cursor = nullptr;
     numElements--;
     return return_value;
 }
@@ -309,7 +384,10 @@ T DoublyLinkedList<T>::pop_back(void) {
     } else {
         head = nullptr; // List becomes empty.
     }
-    delete temp;
+    if (cursor == temp) {
+        cursor = nullptr;
+    }
+    freeNodes(temp, temp, 1);
     numElements--;
     return return_value;
 }
@@ -323,11 +401,7 @@ T& DoublyLinkedList<T>::operator[](size_t index) {
     if (index >= numElements) {
         throw out_of_range("Index is out of bounds.");
     }
-    Node* ptr = head;
-    for (size_t i = 0; i < index; i++) {
-        ptr = ptr->next;
-    }
-    return ptr->value; 
+    return getPointer(index)->value;
 }
 
 // Size operator. This returns the number of elements in the list.
@@ -352,6 +426,7 @@ bool DoublyLinkedList<T>::empty(void) const {
 template <class T>
 DoublyLinkedList<T> DoublyLinkedList<T>::concatenate(const DoublyLinkedList<T> &list) const {
     DoublyLinkedList<T> result;
+    result.reserve(numElements + list.numElements);
     Node *temp = head;
     while (temp != nullptr) {
         result.push_back(temp->value);
@@ -392,3 +467,111 @@ template <class T>
 bool DoublyLinkedList<T>::operator!=(const DoublyLinkedList<T> &rhs) const {
     return !(*this == rhs);
 }
+
+// Splice operator. This moves every element of another list to the end of the current list.
+// Parameter: The list to take the elements from, which becomes empty.
+// Return value: None.
+template <class T>
+void DoublyLinkedList<T>::splice(DoublyLinkedList<T> &list) {
+    splice(numElements, list);
+}
+
+// Splice operator. This moves every element of another list before a given index position of the current list.
+// Parameters: The index position and the list to take the elements from, which becomes empty.
+// Return value: Throws std::out_of_range if the index is out of range.
+// If the lists do not share a pool, the elements are copied into new nodes and the other list is cleared.
+template <class T>
+void DoublyLinkedList<T>::splice(size_t index, DoublyLinkedList<T> &list) {
+    if (index > numElements) {
+        throw out_of_range("Index out of range.");
+    }
+    if (this == &list || list.numElements == 0) {
+        return;
+    }
+    if (numElements == 0) {
+        pool = list.pool; // no node of ours is in use, so we can switch to the pool of the other list
+    }
+    if (pool != list.pool) {
+        // Copy the other list into nodes of our pool, then splice those
+        DoublyLinkedList<T> copy(getPool());
+        copy.reserve(list.numElements);
+        for (Node* node = list.head; node != nullptr; node = node->next) {
+            copy.push_back(node->value);
+        }
+        list.clear();
+        splice(index, copy);
+        return;
+    }
+
+    // Link the chain list.head..list.tail in between 'before' and 'after'
+    Node* after = index == numElements ? nullptr : getPointer(index);
+    Node* before = after == nullptr ? tail : after->prev;
+    list.head->prev = before;
+    list.tail->next = after;
+    if (before != nullptr) {
+        before->next = list.head;
+    } else {
+        head = list.head;
+    }
+    if (after != nullptr) {
+        after->prev = list.tail;
+    } else {
+        tail = list.tail;
+    }
+    numElements += list.numElements;
+    cursor = nullptr;
+
+    list.head = nullptr;
+    list.tail = nullptr;
+    list.numElements = 0;
+    list.cursor = nullptr;
+}
+
+// Bulk append operator. This adds copies of the elements of a range at the end of the doubly linked list.
+// Parameters: Iterators to the first and past the last element of the range.
+// Return value: None.
+template <class T>
+template <class Iterator>
+void DoublyLinkedList<T>::append(Iterator first, Iterator last) {
+    reserve(static_cast<size_t>(distance(first, last)));
+    for (; first != last; ++first) {
+        push_back(*first);
+    }
+}
+
+// Clear operator. This removes every element of the doubly linked list.
+// Parameter: None.
+// Return value: None.
+template <class T>
+void DoublyLinkedList<T>::clear(void) {
+    if (numElements > 0) {
+        freeNodes(head, tail, numElements);
+    }
+    // Set head and tail to nullptr to avoid dangling pointers.
+    head = nullptr;
+    tail = nullptr;
+    cursor = nullptr;
+    // Set the number of elements to 0.
+    numElements = 0;
+}
+
+// Reserve operator. This makes room in the pool for a number of further elements.
+// Parameter: The number of elements.
+// Return value: None.
+template <class T>
+void DoublyLinkedList<T>::reserve(size_t n) {
+    if (n > 0) {
+        getPool()->reserve(n);
+    }
+}
+
+// Pool accessor. This returns the pool of the doubly linked list.
+// Parameter: None.
+// Return value: The pool, created if the list has none yet.
+template <class T>
+shared_ptr<typename DoublyLinkedList<T>::Pool> DoublyLinkedList<T>::getPool(void) {
+    if (pool == nullptr) {
+        pool = make_shared<Pool>();
+    }
+    return pool;
+}
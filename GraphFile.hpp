@@ -0,0 +1,51 @@
+/*
+GraphFile.hpp
+A file that contains the declaration of the GraphFile class, a fast reader for the text graph format:
+a line "n m", then n vertices "id x y", then m edge lines "from to weight name".
+The file is memory-mapped and the numbers are parsed with std::from_chars; the storage is sized from the header
+counts, and the edge lines are split into chunks at line breaks and parsed on several threads.
+The loaders (DirectedGraph::readFromFile and GraphMap::load_file) build their graphs from the parsed records.
+Written by: Khoi V.
+*/
+#pragma once
+
+#include <string>
+#include <vector>
+#include <utility> // for std::pair
+#include <stdexcept> // for std::runtime_error
+
+using namespace std;
+
+class GraphFile {
+public:
+    // One edge line
+    struct Edge {
+        size_t from;
+        size_t to;
+        double weight;
+        string rest; // everything after the weight up to the end of the line; each loader trims it into a name
+    };
+
+    vector<size_t> ids; // vertex ids, in file order
+    vector<pair<double,double>> coords; // coords[i] = (x,y) of the vertex ids[i]
+    vector<Edge> edges; // edges, in file order
+
+    // Reads the file, parsing the edges on the given number of threads (0 = one per hardware thread)
+    // Throws std::runtime_error if the file cannot be opened or is malformed
+    GraphFile(const string& filename, size_t threads = 0);
+
+private:
+    // Moves p past spaces and tabs (and carriage returns), but not past a line break
+    static const char* skipBlanks(const char* p, const char* end);
+    // Moves p past all whitespace, line breaks included
+    static const char* skipSpace(const char* p, const char* end);
+    // Parses a number at p into out; returns the position after it, or nullptr if there is no number
+    template <typename N>
+    static const char* parseNumber(const char* p, const char* end, N& out);
+    // Number of lines in [begin, end) that are not blank
+    static size_t countLines(const char* begin, const char* end);
+    // Parses the edge lines in [begin, end) into edges[first], edges[first + 1], ... up to the last edge
+    void parseEdges(const char* begin, const char* end, size_t first, const string& filename);
+};
+
+#include "GraphFile.tpp"
@@ -0,0 +1,172 @@
+/*
+GraphFile.tpp
+A file that contains the implementation of the GraphFile class.
+Written by: Khoi V.
+*/
+#include "GraphFile.hpp"
+#include <charconv> // for std::from_chars
+#include <cstring> // for std::memchr
+#include <thread>
+#include <exception> // for std::exception_ptr
+#include <algorithm> // for std::min
+#include <sys/mman.h> // for mmap
+#include <sys/stat.h> // for fstat
+#include <fcntl.h> // for open
+#include <unistd.h> // for close
+
+// Constructor
+// Description: Maps the file into memory, reads the header and the vertices, then parses the edge lines in parallel.
+// The edge section is cut into one chunk per thread at line breaks; the threads first count the edge lines of their
+// chunk, so every chunk knows where its edges go, and then parse them straight into the presized edge array.
+// Parameters: filename - the graph file, threads - the number of threads parsing edges, 0 for one per hardware thread.
+// Return value: None.
+// It throws std::runtime_error if the file cannot be opened, a number is missing or there are fewer edges than the header says.
+inline GraphFile::GraphFile(const string& filename, size_t threads) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw runtime_error("Could not open file: " + filename);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw runtime_error("Could not open file: " + filename);
+    }
+    size_t size = info.st_size;
+    void* mapped = size ? mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        throw runtime_error("Could not map file: " + filename);
+    }
+    madvise(mapped, size, MADV_SEQUENTIAL);
+    const char* begin = static_cast<const char*>(mapped);
+    const char* end = begin + size;
+
+    try {
+        // Read the number of vertices and edges
+        size_t n, m;
+        const char* p = parseNumber(skipSpace(begin, end), end, n);
+        if (p) p = parseNumber(skipSpace(p, end), end, m);
+        if (!p) throw runtime_error("Missing vertex and edge counts in " + filename);
+
+        // Read the vertices; each takes at least 6 bytes ("\n0 0 0"), so a count the rest of the file cannot hold is
+        // rejected before anything is allocated for it
+        if (n > size_t(end - p) / 6) throw runtime_error("Malformed vertex count " + to_string(n) + " in " + filename);
+        ids.resize(n);
+        coords.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            p = parseNumber(skipSpace(p, end), end, ids[i]);
+            if (p) p = parseNumber(skipSpace(p, end), end, coords[i].first);
+            if (p) p = parseNumber(skipSpace(p, end), end, coords[i].second);
+            if (!p) throw runtime_error("Malformed vertex " + to_string(i + 1) + " in " + filename);
+        }
+        // the edges start on the line after the last vertex
+        const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+        p = eol ? eol + 1 : end;
+
+        // Cut the edge lines into chunks of at least 1 MB, one per thread
+        if (threads == 0) threads = thread::hardware_concurrency();
+        threads = max<size_t>(1, min<size_t>(threads, (end - p) >> 20));
+        vector<const char*> bounds(threads + 1, end);
+        bounds[0] = p;
+        for (size_t k = 1; k < threads; ++k) {
+            const char* cut = max(bounds[k - 1], p + (end - p) / threads * k);
+            eol = static_cast<const char*>(memchr(cut, '\n', end - cut));
+            bounds[k] = eol ? eol + 1 : end;
+        }
+
+        // Runs job(k) for every chunk k, chunk 0 on this thread; rethrows the first exception of any chunk
+        auto inParallel = [threads](auto job) {
+            vector<exception_ptr> failures(threads);
+            vector<thread> workers;
+            for (size_t k = 1; k < threads; ++k) {
+                workers.emplace_back([&job, &failures, k] {
+                    try { job(k); } catch (...) { failures[k] = current_exception(); }
+                });
+            }
+            try { job(0); } catch (...) { failures[0] = current_exception(); }
+            for (auto &w : workers) w.join();
+            for (auto &f : failures) {
+                if (f) rethrow_exception(f);
+            }
+        };
+
+        vector<size_t> first(threads + 1, 0); // first[k] = index of the first edge in chunk k
+        inParallel([&](size_t k) { first[k + 1] = countLines(bounds[k], bounds[k + 1]); });
+        for (size_t k = 0; k < threads; ++k) first[k + 1] += first[k];
+        if (first[threads] < m) {
+            throw runtime_error("Expected " + to_string(m) + " edges but found " + to_string(first[threads]) + " in " + filename);
+        }
+        edges.resize(m);
+        inParallel([&](size_t k) { parseEdges(bounds[k], bounds[k + 1], first[k], filename); });
+    } catch (...) {
+        munmap(mapped, size);
+        throw;
+    }
+    munmap(mapped, size);
+}
+
+// Function to skip spaces within a line
+// Parameters: p - the current position, end - the end of the buffer.
+// Return value: The first position at or after p that is a line break, a non-space character or end.
+inline const char* GraphFile::skipBlanks(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\v' || *p == '\f')) ++p;
+    return p;
+}
+
+// Function to skip whitespace
+// Parameters: p - the current position, end - the end of the buffer.
+// Return value: The first position at or after p that is not whitespace, or end.
+inline const char* GraphFile::skipSpace(const char* p, const char* end) {
+    while (p < end && (*p == '\n' || *p == ' ' || *p == '\t' || *p == '\r' || *p == '\v' || *p == '\f')) ++p;
+    return p;
+}
+
+// Function to parse a number
+// Parameters: p - the position of the number, end - the end of the buffer, out - receives the value.
+// Return value: The position after the number, or nullptr if there is no number at p.
+// Note: A leading '+' is accepted, as stream extraction does.
+template <typename N>
+const char* GraphFile::parseNumber(const char* p, const char* end, N& out) {
+    if (p < end && *p == '+') ++p;
+    auto [next, err] = from_chars(p, end, out);
+    return err == errc() ? next : nullptr;
+}
+
+// Function to count the edge lines of a chunk
+// Parameters: begin, end - the chunk, which starts at the beginning of a line.
+// Return value: The number of lines with at least one non-space character.
+inline size_t GraphFile::countLines(const char* begin, const char* end) {
+    size_t count = 0;
+    for (const char* p = begin; p < end; ) {
+        const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (!eol) eol = end;
+        if (skipBlanks(p, eol) != eol) count++;
+        p = eol + 1;
+    }
+    return count;
+}
+
+// Function to parse the edge lines of a chunk
+// Parameters: begin, end - the chunk, which starts at the beginning of a line,
+// first - the index of the chunk's first edge, filename - the file name for error messages.
+// Return value: None.
+// Blank lines are skipped, and lines past the m-th edge are ignored.
+// It throws std::runtime_error if a line does not start with two vertex ids and a weight.
+inline void GraphFile::parseEdges(const char* begin, const char* end, size_t first, const string& filename) {
+    size_t i = first;
+    for (const char* p = begin; p < end && i < edges.size(); ) {
+        const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (!eol) eol = end;
+        p = skipBlanks(p, eol);
+        if (p != eol) {
+            Edge& e = edges[i];
+            p = parseNumber(p, eol, e.from);
+            if (p) p = parseNumber(skipBlanks(p, eol), eol, e.to);
+            if (p) p = parseNumber(skipBlanks(p, eol), eol, e.weight);
+            if (!p) throw runtime_error("Malformed edge " + to_string(i + 1) + " in " + filename);
+            e.rest.assign(p, eol);
+            i++;
+        }
+        p = eol + 1;
+    }
+}
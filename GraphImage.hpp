@@ -0,0 +1,88 @@
+/*
+GraphImage.hpp
+A file that contains the declaration of the GraphImage class, a versioned binary file format for a loaded graph.
+The file holds a CSRGraph (vertex values, adjacency arrays, weights, interned edge names, reverse CSR and the
+sorted value index), the vertex coordinates and a coordinate index, each as a flat array at an 8-byte aligned offset.
+Opening an image maps the file read-only and points the arrays of the snapshot at the mapped pages: nothing is
+parsed or allocated per vertex, so a process can answer queries a few milliseconds after it starts, and the pages
+are only read from disk as the searches touch them.
+The file is written in the byte order and type sizes of the machine, and only machines with the same layout can read it.
+Written by: Khoi V.
+*/
+#pragma once
+
+#include <string>
+#include <vector>
+#include <utility> // for std::pair
+#include <cstdint> // for uint32_t, uint64_t
+#include <type_traits> // for std::is_trivially_copyable
+#include <stdexcept> // for std::runtime_error
+#include "CSRGraph.hpp"
+
+using namespace std;
+
+template <typename T>
+class GraphImage {
+    static_assert(is_trivially_copyable<T>::value, "vertex values must be trivially copyable to be stored in an image");
+
+private:
+    // The sections of the file, in file order
+    enum Section { VALUES, COORDS, BY_VALUE, BY_COORD, OFFSETS, TARGETS, WEIGHTS, NAME_IDS,
+                   NAME_OFFSETS, NAME_CHARS, REV_OFFSETS, REV_SOURCES, REV_EDGES, SECTIONS };
+
+    // The start of the file
+    struct Header {
+        char magic[8]; // MAGIC
+        uint32_t version; // VERSION of the writer
+        uint32_t valueSize; // sizeof(T) of the writer
+        uint64_t numVertices;
+        uint64_t numEdges;
+        uint64_t numNames; // distinct edge names
+        uint64_t nameBytes; // total length of the distinct names
+        double costPerMetre; // GreatCircleHeuristic::minCostPerMetre of the graph
+        uint64_t sections[SECTIONS]; // byte offset of every section
+    };
+
+    void* mapping = nullptr; // the mapped file
+    size_t mappedSize = 0;
+    CSRGraph<T> net; // arrays point into the mapping
+    CSRArray<pair<double,double>> coords; // coords[i] = (x,y) of vertex i
+    CSRArray<uint32_t> byCoord; // vertex indices sorted by (x,y), ties by index
+    double costPerMetre = 0.0;
+
+    // Number of bytes of section s of a file with the given header
+    static size_t sectionSize(const Header& h, int s);
+
+public:
+    // First bytes of every image file
+    static constexpr char MAGIC[8] = {'C', 'S', 'R', 'I', 'M', 'G', '\0', '\0'};
+    // Format version; readers reject other versions
+    static constexpr uint32_t VERSION = 1;
+
+    // True if the file starts like an image (any version), false for text graphs or unreadable files
+    static bool isImage(const string& filename);
+
+    // Writes the snapshot and the coordinates of its vertices (by index) as an image
+    // Throws std::runtime_error if the file cannot be written
+    static void write(const string& filename, const CSRGraph<T>& g, const vector<pair<double,double>>& coords);
+
+    // Maps the image file; throws std::runtime_error if it cannot be read, is not an image,
+    // has another version or value size, or is truncated
+    GraphImage(const string& filename);
+    // Unmaps the file
+    ~GraphImage();
+    // The snapshot views the mapping, so the image cannot be copied
+    GraphImage(const GraphImage<T>&) = delete;
+    GraphImage<T>& operator=(const GraphImage<T>&) = delete;
+
+    // The snapshot, valid as long as the image
+    const CSRGraph<T>& graph() const;
+    // coordinates()[i] = (x,y) of vertex i
+    const pair<double,double>* coordinates() const;
+    // Smallest cost per metre of any edge, for the A* heuristic (computed when the image was written)
+    double minCostPerMetre() const;
+    // Index of the vertex at exactly (x,y) (the last one if several share it), or CSRGraph<T>::NONE
+    size_t findCoordinate(double x, double y) const;
+};
+
+#include "GraphImage.tpp"
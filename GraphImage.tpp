@@ -0,0 +1,217 @@
+/*
+GraphImage.tpp
+A file that contains the implementation of the GraphImage class.
+Written by: Khoi V.
+*/
+#include "GraphImage.hpp"
+#include "GreatCircleHeuristic.hpp"
+#include <fstream>
+#include <cstring> // for std::memcmp, std::memcpy
+#include <algorithm> // for std::stable_sort, std::upper_bound
+#include <sys/mman.h> // for mmap
+#include <sys/stat.h> // for fstat
+#include <fcntl.h> // for open
+#include <unistd.h> // for close
+
+// Function to get the size of a section
+// Parameters: h - the header of the file, s - the section.
+// Return value: The number of bytes of the section.
+template <typename T>
+size_t GraphImage<T>::sectionSize(const Header& h, int s) {
+    size_t n = h.numVertices, m = h.numEdges;
+    switch (s) {
+    case VALUES: return n * sizeof(T);
+    case COORDS: return n * sizeof(pair<double,double>);
+    case BY_VALUE: case BY_COORD: return n * sizeof(uint32_t);
+    case OFFSETS: case REV_OFFSETS: return (n + 1) * sizeof(size_t);
+    case TARGETS: case NAME_IDS: case REV_SOURCES: case REV_EDGES: return m * sizeof(uint32_t);
+    case WEIGHTS: return m * sizeof(double);
+    case NAME_OFFSETS: return (h.numNames + 1) * sizeof(size_t);
+    default: return h.nameBytes;
+    }
+}
+
+// Function to check whether a file is an image
+// Parameters: filename - the file to check.
+// Return value: true if the file starts with MAGIC, false otherwise (also if it cannot be read).
+template <typename T>
+bool GraphImage<T>::isImage(const string& filename) {
+    ifstream file(filename, ios::binary);
+    char magic[sizeof(MAGIC)];
+    return file.read(magic, sizeof(magic)) && memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+// Function to write an image
+// Description: Writes the header and then every array of the snapshot, each at the next multiple of 8 bytes,
+// together with the coordinates, a coordinate index and the A* cost bound, so opening the image computes nothing.
+// Parameters: filename - the file to write, g - the snapshot,
+// coords - coordinates of the vertices of g by index (coords.size() must be g.numVertices()).
+// Return value: None.
+// It throws std::runtime_error if the coordinates do not match the graph or the file cannot be written.
+template <typename T>
+void GraphImage<T>::write(const string& filename, const CSRGraph<T>& g, const vector<pair<double,double>>& coords) {
+    static_assert(sizeof(size_t) == sizeof(uint64_t), "images store offsets as 64-bit values");
+    size_t n = g.numVertices();
+    if (coords.size() != n) {
+        throw runtime_error("Expected " + to_string(n) + " coordinates but got " + to_string(coords.size()));
+    }
+
+    // Sort the vertices by coordinates for findCoordinate
+    vector<uint32_t> sorted(n);
+    for (size_t i = 0; i < n; ++i) sorted[i] = static_cast<uint32_t>(i);
+    stable_sort(sorted.begin(), sorted.end(), [&coords](uint32_t a, uint32_t b) { return coords[a] < coords[b]; });
+
+    Header h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, MAGIC, sizeof(MAGIC));
+    h.version = VERSION;
+    h.valueSize = sizeof(T);
+    h.numVertices = n;
+    h.numEdges = g.numEdges();
+    h.numNames = g.nameOffsets.size() - 1;
+    h.nameBytes = g.nameChars.size();
+    h.costPerMetre = GreatCircleHeuristic::minCostPerMetre(g, coords);
+    const void* data[SECTIONS] = { g.values.begin(), coords.data(), g.byValue.begin(), sorted.data(),
+                                   g.offsets.begin(), g.targets.begin(), g.weights.begin(), g.nameIds.begin(),
+                                   g.nameOffsets.begin(), g.nameChars.begin(), g.revOffsets.begin(),
+                                   g.revSources.begin(), g.revEdges.begin() };
+    size_t at = (sizeof(Header) + 7) / 8 * 8;
+    for (int s = 0; s < SECTIONS; ++s) {
+        h.sections[s] = at;
+        at = (at + sectionSize(h, s) + 7) / 8 * 8;
+    }
+
+    ofstream file(filename, ios::binary | ios::trunc);
+    if (!file.is_open()) {
+        throw runtime_error("Could not open file: " + filename);
+    }
+    const char zeros[8] = {0};
+    file.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    size_t written = sizeof(h);
+    for (int s = 0; s < SECTIONS; ++s) {
+        file.write(zeros, h.sections[s] - written);
+        if (sectionSize(h, s) > 0) file.write(static_cast<const char*>(data[s]), sectionSize(h, s));
+        written = h.sections[s] + sectionSize(h, s);
+    }
+    file.write(zeros, at - written);
+    if (!file) {
+        throw runtime_error("Could not write file: " + filename);
+    }
+}
+
+// Constructor
+// Description: Maps the file read-only and checks the header, the section bounds and the ends of the offset arrays.
+// The rest of the data is trusted: the arrays are used where they lie, without being read at all.
+// Parameters: filename - the image file.
+// Return value: None.
+// It throws std::runtime_error if the file cannot be read or is not a valid image of this version.
+template <typename T>
+GraphImage<T>::GraphImage(const string& filename) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw runtime_error("Could not open file: " + filename);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header)) {
+        close(fd);
+        throw runtime_error("Not a graph image: " + filename);
+    }
+    mappedSize = info.st_size;
+    mapping = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        mapping = nullptr;
+        throw runtime_error("Could not map file: " + filename);
+    }
+
+    const char* base = static_cast<const char*>(mapping);
+    const Header& h = *reinterpret_cast<const Header*>(base);
+    string problem;
+    if (memcmp(h.magic, MAGIC, sizeof(MAGIC)) != 0) problem = "not a graph image";
+    else if (h.version != VERSION) problem = "image version " + to_string(h.version) + ", expected " + to_string(VERSION);
+    else if (h.valueSize != sizeof(T)) problem = "vertex values of " + to_string(h.valueSize) + " bytes, expected " + to_string(sizeof(T));
+    for (int s = 0; problem.empty() && s < SECTIONS; ++s) {
+        if (h.sections[s] % 8 != 0 || h.sections[s] > mappedSize || sectionSize(h, s) > mappedSize - h.sections[s]) {
+            problem = "truncated image";
+        }
+    }
+    if (problem.empty()) {
+        const size_t* offs = reinterpret_cast<const size_t*>(base + h.sections[OFFSETS]);
+        const size_t* revOffs = reinterpret_cast<const size_t*>(base + h.sections[REV_OFFSETS]);
+        const size_t* nameOffs = reinterpret_cast<const size_t*>(base + h.sections[NAME_OFFSETS]);
+        if (offs[0] != 0 || offs[h.numVertices] != h.numEdges || revOffs[0] != 0 || revOffs[h.numVertices] != h.numEdges
+            || nameOffs[0] != 0 || nameOffs[h.numNames] != h.nameBytes || h.numVertices > numeric_limits<uint32_t>::max()) {
+            problem = "corrupt image";
+        }
+    }
+    if (!problem.empty()) {
+        munmap(mapping, mappedSize);
+        mapping = nullptr;
+        throw runtime_error(filename + ": " + problem);
+    }
+
+    // Point every array at its section
+    auto view = [&](auto& array, int s, size_t count) {
+        using Array = typename remove_reference<decltype(array)>::type;
+        array = Array(reinterpret_cast<decltype(array.begin())>(base + h.sections[s]), count);
+    };
+    size_t n = h.numVertices, m = h.numEdges;
+    view(net.values, VALUES, n);
+    view(net.offsets, OFFSETS, n + 1);
+    view(net.targets, TARGETS, m);
+    view(net.weights, WEIGHTS, m);
+    view(net.nameIds, NAME_IDS, m);
+    view(net.nameOffsets, NAME_OFFSETS, h.numNames + 1);
+    view(net.nameChars, NAME_CHARS, h.nameBytes);
+    view(net.revOffsets, REV_OFFSETS, n + 1);
+    view(net.revSources, REV_SOURCES, m);
+    view(net.revEdges, REV_EDGES, m);
+    view(net.byValue, BY_VALUE, n);
+    view(coords, COORDS, n);
+    view(byCoord, BY_COORD, n);
+    costPerMetre = h.costPerMetre;
+}
+
+// Destructor
+// Parameters: None.
+// Return value: None.
+template <typename T>
+GraphImage<T>::~GraphImage() {
+    if (mapping) munmap(mapping, mappedSize);
+}
+
+// Function to get the snapshot
+// Parameters: None.
+// Return value: The snapshot, whose arrays live in the mapped file.
+template <typename T>
+const CSRGraph<T>& GraphImage<T>::graph() const {
+    return net;
+}
+
+// Function to get the coordinates
+// Parameters: None.
+// Return value: The coordinates of the vertices by index, in the mapped file.
+template <typename T>
+const pair<double,double>* GraphImage<T>::coordinates() const {
+    return coords.begin();
+}
+
+// Function to get the A* cost bound
+// Parameters: None.
+// Return value: The smallest cost per metre of any edge, as written by write.
+template <typename T>
+double GraphImage<T>::minCostPerMetre() const {
+    return costPerMetre;
+}
+
+// Function to find a vertex by its coordinates
+// Parameters: x, y - the coordinates.
+// Return value: The index of the vertex at exactly (x,y), the last one if several are there; CSRGraph<T>::NONE if none.
+template <typename T>
+size_t GraphImage<T>::findCoordinate(double x, double y) const {
+    pair<double,double> key(x, y);
+    auto it = upper_bound(byCoord.begin(), byCoord.end(), key,
+                          [this](const pair<double,double>& k, uint32_t i) { return k < coords[i]; });
+    if (it == byCoord.begin() || coords[*(it - 1)] != key) return CSRGraph<T>::NONE;
+    return *(it - 1);
+}
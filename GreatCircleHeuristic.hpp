@@ -0,0 +1,45 @@
+/*
+GreatCircleHeuristic.hpp
+A file that contains the declaration of the great-circle heuristic for A* search on road maps.
+The heuristic estimates the remaining cost from a vertex to the target as the great-circle distance between
+their coordinates times the smallest cost per metre of any edge in the graph. No edge is cheaper than that per
+metre, and no path is shorter than the great circle, so the estimate never overestimates (it is admissible).
+Written by: Khoi V.
+*/
+#pragma once
+
+#include <vector>
+#include <utility> // for std::pair
+#include "CSRGraph.hpp"
+
+using namespace std;
+
+class GreatCircleHeuristic {
+private:
+    // coords[i] = (longitude, latitude) in degrees of vertex i of the snapshot
+    const pair<double,double>* coords;
+    // lower bound on the cost of one metre of road
+    double scale;
+    // coordinates of the target
+    pair<double,double> goal;
+
+public:
+    // Mean radius of the Earth in metres
+    static constexpr double EARTH_RADIUS = 6371008.8;
+
+    // Builds the heuristic for the given target vertex
+    GreatCircleHeuristic(const vector<pair<double,double>>& coords, double scale, size_t target);
+    // Same, with the coordinates in any array (for example a memory-mapped GraphImage)
+    GreatCircleHeuristic(const pair<double,double>* coords, double scale, size_t target);
+    // Estimated cost from vertex i to the target
+    double operator()(size_t i) const;
+    // Great-circle (haversine) distance in metres between two (longitude, latitude) points
+    static double distance(const pair<double,double>& a, const pair<double,double>& b);
+    // Smallest ratio of edge weight to great-circle edge length over all edges of the graph
+    template <typename T>
+    static double minCostPerMetre(const CSRGraph<T>& g, const vector<pair<double,double>>& coords);
+    template <typename T>
+    static double minCostPerMetre(const CSRGraph<T>& g, const pair<double,double>* coords);
+};
+
+#include "GreatCircleHeuristic.tpp"
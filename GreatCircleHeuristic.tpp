@@ -0,0 +1,68 @@
+/*
+GreatCircleHeuristic.tpp
+A file that contains the implementation of the great-circle heuristic for A* search on road maps.
+Written by: Khoi V.
+*/
+#include "GreatCircleHeuristic.hpp"
+#include <cmath>
+#include <limits>
+
+// Constructor
+// Parameters: coords - coordinates of the vertices by snapshot index (kept by reference, must outlive the heuristic),
+// scale - lower bound on the cost per metre (see minCostPerMetre), target - the index of the target vertex.
+// Return value: None.
+inline GreatCircleHeuristic::GreatCircleHeuristic(const vector<pair<double,double>>& coords, double scale, size_t target)
+    : GreatCircleHeuristic(coords.data(), scale, target) {
+}
+
+// Constructor
+// Parameters: coords - array of the coordinates of the vertices by snapshot index (must outlive the heuristic),
+// scale - lower bound on the cost per metre (see minCostPerMetre), target - the index of the target vertex.
+// Return value: None.
+inline GreatCircleHeuristic::GreatCircleHeuristic(const pair<double,double>* coords, double scale, size_t target)
+    : coords(coords), scale(scale), goal(coords[target]) {
+}
+
+// Function to estimate the cost from a vertex to the target
+// Parameters: i - the index of the vertex.
+// Return value: The great-circle distance from vertex i to the target times the cost per metre.
+inline double GreatCircleHeuristic::operator()(size_t i) const {
+    return scale * distance(coords[i], goal);
+}
+
+// Function to compute the great-circle distance between two points with the haversine formula
+// Parameters: a, b - (longitude, latitude) pairs in degrees.
+// Return value: The distance in metres.
+inline double GreatCircleHeuristic::distance(const pair<double,double>& a, const pair<double,double>& b) {
+    const double RAD = M_PI / 180.0;
+    double dLat = (b.second - a.second) * RAD;
+    double dLon = (b.first - a.first) * RAD;
+    double s = sin(dLat / 2) * sin(dLat / 2)
+             + cos(a.second * RAD) * cos(b.second * RAD) * sin(dLon / 2) * sin(dLon / 2);
+    return 2.0 * EARTH_RADIUS * asin(sqrt(min(1.0, s)));
+}
+
+// Function to compute the smallest cost per metre over all edges
+// Parameters: g - the graph snapshot, coords - coordinates of its vertices by index.
+// Return value: The smallest weight / length ratio of any edge of non-zero length, shaved slightly so rounding
+// cannot make the heuristic overestimate; 0 if the graph has no such edge (A* then behaves like Dijkstra's algorithm).
+template <typename T>
+double GreatCircleHeuristic::minCostPerMetre(const CSRGraph<T>& g, const vector<pair<double,double>>& coords) {
+    return minCostPerMetre(g, coords.data());
+}
+
+// Function to compute the smallest cost per metre over all edges
+// Parameters: g - the graph snapshot, coords - array of the coordinates of its vertices by index.
+// Return value: As above.
+template <typename T>
+double GreatCircleHeuristic::minCostPerMetre(const CSRGraph<T>& g, const pair<double,double>* coords) {
+    double best = numeric_limits<double>::infinity();
+    for (size_t u = 0; u < g.numVertices(); ++u) {
+        for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); ++e) {
+            double len = distance(coords[u], coords[g.edgeTarget(e)]);
+            if (len > 0) best = min(best, g.edgeWeight(e) / len);
+        }
+    }
+    if (best == numeric_limits<double>::infinity()) return 0.0;
+    return best * (1.0 - 1e-9);
+}
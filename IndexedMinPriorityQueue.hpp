@@ -0,0 +1,70 @@
+/*
+IndexedMinPriorityQueue.hpp
+A file that contains the templated declarations for the indexed priority queue (d-ary Min-Heap version).
+The values in the queue are dense indices 0..n-1 (e.g. vertex indices), so the position of each value
+is kept in a plain array instead of a hash table, and each key is stored inline next to its value.
+The arity D of the heap is a template parameter (2 for a binary heap, 4 for a 4-ary heap).
+Written by: Duc T.
+*/
+
+#pragma once
+#include <iostream>
+#include <vector>
+#include <utility> // for std::pair
+#include <limits> // for std::numeric_limits
+
+using namespace std;
+
+// Indexed Min-PQ implementation, with an underlying d-ary min-heap
+template<class K, unsigned D = 4>
+class indexedMinPQ {
+
+    private:
+
+    vector<pair<K, size_t>> heap; // the heap of (key, index) entries
+    vector<size_t> position; // position[i] = slot of index i in the heap, or ABSENT
+
+    static constexpr size_t ABSENT = numeric_limits<size_t>::max();
+
+    // Moves the entry at slot s towards the root / the leaves until the min-heap property holds
+    void siftUp(size_t s);
+    void siftDown(size_t s);
+
+    public:
+
+    // Default constructor
+    // Values must lie in 0..n-1
+    indexedMinPQ(size_t n = 0);
+
+    // Empties the queue and makes room for the values 0..n-1
+    // Note: only the entries still queued are touched when n is unchanged, so the queue can be reused cheaply
+    void reset(size_t n);
+
+    // throw std::out_of_range if the queue is empty
+    pair<K, size_t> top(void) const;
+
+    // throw std::out_of_range if the queue is empty
+    pair<K, size_t> pop(void);
+
+    // throw std::out_of_range if the index is not in the queue
+    // throw std::out_of_range if old key is LESS THAN new key
+    void updateKey(K newKey, size_t index);
+
+    // throw std::out_of_range if the index is out of range or already in the queue
+    void insert(K key, size_t index);
+
+    // Lazy insert: inserts the index if it is not queued, or lowers its key if newKey is smaller
+    // Return value: true if the queue changed
+    bool insertOrDecrease(K key, size_t index);
+
+    bool contains(size_t index) const;
+
+    // throw std::out_of_range if the index is not in the queue
+    K keyOf(size_t index) const;
+
+    size_t size(void) const;
+
+    bool empty(void) const;
+};
+
+#include "IndexedMinPriorityQueue.tpp"
@@ -0,0 +1,170 @@
+/*
+File name: IndexedMinPriorityQueue.tpp
+A file that contains the implementation of the indexed PQ class methods (d-ary Min-Heap version).
+Written by: Duc T.
+*/
+
+#include <iostream>
+#include <vector>
+#include <utility>
+#include <stdexcept>
+#include "IndexedMinPriorityQueue.hpp"
+
+using namespace std;
+
+// SiftUp function. Moves the entry at slot s up while its parent has a larger key.
+// The entry is held aside and written once, so each level costs one move instead of a swap.
+template<class K, unsigned D>
+void indexedMinPQ<K, D>::siftUp(size_t s) {
+    pair<K, size_t> entry = heap[s];
+    while (s > 0) {
+        size_t p = (s - 1) / D;
+        if (!(entry.first < heap[p].first)) break;
+        heap[s] = heap[p];
+        position[heap[s].second] = s;
+        s = p;
+    }
+    heap[s] = entry;
+    position[entry.second] = s;
+}
+
+// SiftDown function. Moves the entry at slot s down while one of its D children has a smaller key.
+template<class K, unsigned D>
+void indexedMinPQ<K, D>::siftDown(size_t s) {
+    pair<K, size_t> entry = heap[s];
+    size_t n = heap.size();
+    while (true) {
+        size_t first = D * s + 1;
+        if (first >= n) break;
+        size_t last = first + D < n ? first + D : n;
+        size_t smallest = first;
+        for (size_t c = first + 1; c < last; c++) {
+            if (heap[c].first < heap[smallest].first) smallest = c;
+        }
+        if (!(heap[smallest].first < entry.first)) break;
+        heap[s] = heap[smallest];
+        position[heap[s].second] = s;
+        s = smallest;
+    }
+    heap[s] = entry;
+    position[entry.second] = s;
+}
+
+// Default constructor. Initializes an empty queue for the values 0..n-1.
+template<class K, unsigned D>
+indexedMinPQ<K, D>::indexedMinPQ(size_t n) {
+    static_assert(D >= 2, "The heap arity must be at least 2.");
+    position.assign(n, ABSENT);
+}
+
+// Reset function. Empties the queue and makes room for the values 0..n-1.
+template<class K, unsigned D>
+void indexedMinPQ<K, D>::reset(size_t n) {
+    if (n == position.size()) {
+        for (auto &entry : heap) {
+            position[entry.second] = ABSENT;
+        }
+    } else {
+        position.assign(n, ABSENT);
+    }
+    heap.clear();
+}
+
+// Top function. Returns the minimum entry in the heap.
+template<class K, unsigned D>
+pair<K, size_t> indexedMinPQ<K, D>::top(void) const {
+    if (heap.empty()) {
+        throw out_of_range("The queue is empty.");
+    }
+    return heap[0];
+}
+
+// Pop function. Removes and returns the minimum entry from the heap.
+template<class K, unsigned D>
+pair<K, size_t> indexedMinPQ<K, D>::pop(void) {
+    if (heap.empty()) {
+        throw out_of_range("The queue is empty.");
+    }
+    pair<K, size_t> min = heap[0];
+    position[min.second] = ABSENT;
+    heap[0] = heap.back();
+    heap.pop_back();
+    if (!heap.empty()) {
+        siftDown(0);
+    }
+    return min;
+}
+
+// UpdateKey function. Lowers the key of the given index.
+template<class K, unsigned D>
+void indexedMinPQ<K, D>::updateKey(K newKey, size_t index) {
+    if (!contains(index)) {
+        throw out_of_range("Value is not in the queue.");
+    }
+    size_t s = position[index];
+    if (newKey > heap[s].first) {
+        throw out_of_range("Old key is LESS THAN new key.");
+    }
+    heap[s].first = newKey;
+    siftUp(s);
+}
+
+// Insert function. Inserts a new entry into the heap.
+template<class K, unsigned D>
+void indexedMinPQ<K, D>::insert(K key, size_t index) {
+    if (index >= position.size()) {
+        throw out_of_range("Value is out of range.");
+    }
+    if (position[index] != ABSENT) {
+        throw out_of_range("Value is already in the queue.");
+    }
+    heap.push_back(pair<K, size_t>(key, index));
+    siftUp(heap.size() - 1);
+}
+
+// InsertOrDecrease function. Inserts the index if it is not queued, or lowers its key if key is smaller.
+template<class K, unsigned D>
+bool indexedMinPQ<K, D>::insertOrDecrease(K key, size_t index) {
+    if (index >= position.size()) {
+        throw out_of_range("Value is out of range.");
+    }
+    size_t s = position[index];
+    if (s == ABSENT) {
+        heap.push_back(pair<K, size_t>(key, index));
+        siftUp(heap.size() - 1);
+        return true;
+    }
+    if (key < heap[s].first) {
+        heap[s].first = key;
+        siftUp(s);
+        return true;
+    }
+    return false;
+}
+
+// Contains function. Returns true if the index is currently in the queue.
+template<class K, unsigned D>
+bool indexedMinPQ<K, D>::contains(size_t index) const {
+    return index < position.size() && position[index] != ABSENT;
+}
+
+// KeyOf function. Returns the key of the given index.
+template<class K, unsigned D>
+K indexedMinPQ<K, D>::keyOf(size_t index) const {
+    if (!contains(index)) {
+        throw out_of_range("Value is not in the queue.");
+    }
+    return heap[position[index]].first;
+}
+
+// Size function. Returns the number of entries in the heap.
+template<class K, unsigned D>
+size_t indexedMinPQ<K, D>::size(void) const {
+    return heap.size();
+}
+
+// Empty function. Returns true if the heap is empty, false otherwise.
+template<class K, unsigned D>
+bool indexedMinPQ<K, D>::empty(void) const {
+    return heap.empty();
+}
@@ -17,10 +17,9 @@ class minPQ {
 
     private:
     
-    V* arr; // the heap
-    // use hash tables/maps to keep track of indices and keys.
+    pair<K, V>* arr; // the heap, with each key stored next to its value
+    // use a hash table/map to keep track of the index of each value in the heap.
     unordered_map<V, int> indexOf;
-    unordered_map<V, K> keyOf;
 
     size_t capacity;
     size_t numElements;
@@ -31,6 +30,8 @@ class minPQ {
 
     // Heapify function
     void heapify(int i, size_t size);
+    // Moves the entry at index i up until its parent's key is not greater
+    void siftUp(int i);
     void buildHeap(size_t n);
 
     public:
@@ -32,21 +32,40 @@ int minPQ<K, V>::parent(int i) {
 }
 
 // Heapify function. Maintains the min-heap property of the sub-heap rooted at index i.
+// Iterative, and keeps indexOf in step with every entry it moves.
 template<class K, class V>
 void minPQ<K, V>::heapify(int i, size_t size) {
-    int l = left(i);
-    int r = right(i);
-    int smallest = i;
-    if (l < static_cast<int>(size) && keyOf[arr[l]] < keyOf[arr[i]]) {
-        smallest = l;
-    }
-    if (r < static_cast<int>(size) && keyOf[arr[r]] < keyOf[arr[smallest]]) {
-        smallest = r;
-    }
-    if (smallest != i) {
+    while (true) {
+        int l = left(i);
+        int r = right(i);
+        int smallest = i;
+        if (l < static_cast<int>(size) && arr[l].first < arr[i].first) {
+            smallest = l;
+        }
+        if (r < static_cast<int>(size) && arr[r].first < arr[smallest].first) {
+            smallest = r;
+        }
+        if (smallest == i) {
+            return;
+        }
         swap(arr[i], arr[smallest]);
-        heapify(smallest, size);
+        indexOf[arr[i].second] = i;
+        indexOf[arr[smallest].second] = smallest;
+        i = smallest;
+    }
+}
+
+// SiftUp function. Moves the entry at index i towards the root until the min-heap property holds.
+template<class K, class V>
+void minPQ<K, V>::siftUp(int i) {
+    pair<K, V> entry = arr[i];
+    while (i > 0 && arr[parent(i)].first > entry.first) {
+        arr[i] = arr[parent(i)];
+        indexOf[arr[i].second] = i;
+        i = parent(i);
     }
+    arr[i] = entry;
+    indexOf[entry.second] = i;
 }
 
 // BuildHeap function. Builds a min-heap from the unordered array.
@@ -62,7 +81,7 @@ template<class K, class V>
 minPQ<K, V>::minPQ(size_t capacity) {
     this->capacity = capacity;
     this->numElements = 0;
-    this->arr = new V[capacity];
+    this->arr = new pair<K, V>[capacity];
 }
 
 // Copy constructor. Initializes the heap with the same elements as the given heap.
@@ -70,12 +89,11 @@ template<class K, class V>
 minPQ<K, V>::minPQ(const minPQ<K, V> &pq) {
     this->capacity = pq.capacity;
     this->numElements = pq.numElements;
-    this->arr = new V[capacity];
+    this->arr = new pair<K, V>[capacity];
     for (size_t i = 0; i < numElements; i++) {
         this->arr[i] = pq.arr[i];
     }
     indexOf = pq.indexOf;
-    keyOf = pq.keyOf;
 }
 
 // Assignment operator. Implements copy/swap idiom.
@@ -85,7 +103,6 @@ minPQ<K, V>& minPQ<K, V>::operator=(minPQ<K, V> rhs) {
     swap(this->capacity, rhs.capacity);
     swap(this->numElements, rhs.numElements);
     swap(indexOf, rhs.indexOf);
-    swap(keyOf, rhs.keyOf);
     return *this;
 }
 
@@ -114,9 +131,7 @@ pair<K, V> minPQ<K, V>::top(void) {
     if (this->numElements == 0) {
         throw out_of_range("The queue is empty.");
     }
-    V minVal = arr[0];
-    K minKey = keyOf[minVal];
-    return pair<K, V>(minKey, minVal);
+    return arr[0];
 }
 
 // Pop function. Removes and returns the minimum element from the heap.
@@ -125,39 +140,30 @@ pair<K, V> minPQ<K, V>::pop(void) {
     if (this->numElements == 0) {
         throw out_of_range("The queue is empty.");
     }
-    V minVal = arr[0];
-    K minKey = keyOf[minVal];
-    arr[0] = arr[this->numElements - 1];
-    indexOf[arr[0]] = 0;
+    pair<K, V> min = arr[0];
     this->numElements--;
-    keyOf.erase(minVal);
-    indexOf.erase(minVal);
-    heapify(0, this->numElements);
-    return pair<K, V>(minKey, minVal);
+    indexOf.erase(min.second);
+    if (this->numElements > 0) {
+        arr[0] = arr[this->numElements];
+        indexOf[arr[0].second] = 0;
+        heapify(0, this->numElements);
+    }
+    return min;
 }
 
 // UpdateKey function. Updates the key of the given value.
 template<class K, class V>
 void minPQ<K, V>::updateKey(K newKey, V value) {
-    if (keyOf.find(value) == keyOf.end()) {
+    auto it = indexOf.find(value);
+    if (it == indexOf.end()) {
         throw out_of_range("Value is not in the queue.");
     }
-    if (newKey > keyOf[value]) {
+    int i = it->second;
+    if (newKey > arr[i].first) {
         throw out_of_range("Old key is LESS THAN new key.");
     }
-    keyOf[value] = newKey;
-    int i = 0;
-    if (indexOf.find(value) != indexOf.end())
-        i = indexOf[value];
-    else
-        throw out_of_range("Value is not in the queue.");
-    
-    while (i > 0 && keyOf[arr[parent(i)]] > keyOf[arr[i]]) {
-        swap(arr[i], arr[parent(i)]);
-        indexOf[arr[i]] = i;
-        indexOf[arr[parent(i)]] = parent(i);
-        i = parent(i);
-    }
+    arr[i].first = newKey;
+    siftUp(i);
 }
 
 // Insert function. Inserts a new element into the heap.
@@ -166,17 +172,10 @@ void minPQ<K, V>::insert(K key, V value) {
     if (this->numElements == this->capacity) {
         throw overflow_error("The queue is full");
     }
-    arr[this->numElements] = value;
-    keyOf[value] = key;
-    indexOf[value] = this->numElements;
+    arr[this->numElements] = pair<K, V>(key, value);
     int i = this->numElements;
     this->numElements++;
-    while (i > 0 && keyOf[arr[parent(i)]] > keyOf[arr[i]]) {
-        swap(arr[i], arr[parent(i)]);
-        indexOf[arr[i]] = i;
-        indexOf[arr[parent(i)]] = parent(i);
-        i = parent(i);
-    }
+    siftUp(i);
 }
 
 // fromArrays function. Initializes the heap with the given arrays and builds the heap.
@@ -184,11 +183,9 @@ template<class K, class V>
 void minPQ<K, V>::fromArrays(K *keys, V *values, int n) {
     numElements = n;
     indexOf.clear();
-    keyOf.clear();
-    for (int i = 0; i < numElements; i++) {
-        arr[i] = values[i];
+    for (int i = 0; i < n; i++) {
+        arr[i] = pair<K, V>(keys[i], values[i]);
         indexOf[values[i]] = i;
-        keyOf[values[i]] = keys[i];
     }
     buildHeap(n);
 }
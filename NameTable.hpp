@@ -0,0 +1,46 @@
+/*
+NameTable.hpp
+A file that contains the declaration of the NameTable class, the process-wide table of interned edge names.
+Real maps name thousands of edges after a few hundred streets, so vertices do not store a string per edge: each
+name is stored once here and edges refer to it by a 32-bit ID. ID 0 is the empty name. Names are never removed,
+so an ID, and the reference name() returns for it, stay valid for the life of the process.
+The table is safe to use from several threads at once.
+Written by: Khoi V.
+*/
+#pragma once
+
+#include <string>
+#include <string_view> // for std::string_view
+#include <deque>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint> // for uint32_t
+
+using namespace std;
+
+class NameTable {
+private:
+    mutable mutex lock; // guards names and index
+    deque<string> names; // names[id]; a deque never moves its elements, so index can view them
+    unordered_map<string_view, uint32_t> index; // index[name] = its ID
+
+    NameTable();
+
+public:
+    // The table of the process
+    static NameTable& global();
+
+    NameTable(const NameTable&) = delete;
+    NameTable& operator=(const NameTable&) = delete;
+
+    // ID of a name, adding it to the table if it is new
+    uint32_t intern(string_view name);
+
+    // Name with the given ID; throws std::out_of_range if no name has it
+    const string& name(uint32_t id) const;
+
+    // Number of distinct names, the empty one included
+    size_t size() const;
+};
+
+#include "NameTable.tpp"
@@ -0,0 +1,58 @@
+/*
+NameTable.tpp
+A file that contains the implementation of the NameTable class.
+Written by: Khoi V.
+*/
+#include "NameTable.hpp"
+#include <stdexcept> // for std::out_of_range, std::length_error
+#include <limits> // for std::numeric_limits
+
+// Constructor
+// Parameters: None.
+// Return value: None.
+// The empty name is added first, so it gets ID 0.
+inline NameTable::NameTable() {
+    names.emplace_back();
+    index.emplace(names.back(), 0);
+}
+
+// Function to get the table of the process
+// Parameters: None.
+// Return value: The table, created on first use.
+inline NameTable& NameTable::global() {
+    static NameTable table;
+    return table;
+}
+
+// Function to intern a name
+// Parameters: name - the name to look up.
+// Return value: The ID of the name, a new one if the table did not hold it.
+// It throws std::length_error if the table already holds 2^32 names.
+inline uint32_t NameTable::intern(string_view name) {
+    lock_guard<mutex> guard(lock);
+    auto it = index.find(name);
+    if (it != index.end()) return it->second;
+    if (names.size() > numeric_limits<uint32_t>::max()) throw length_error("Too many edge names");
+    uint32_t id = static_cast<uint32_t>(names.size());
+    names.emplace_back(name);
+    index.emplace(names.back(), id);
+    return id;
+}
+
+// Function to look up a name
+// Parameters: id - the ID of the name.
+// Return value: A reference to the name, valid for the life of the process.
+// It throws std::out_of_range if no name has the ID.
+inline const string& NameTable::name(uint32_t id) const {
+    lock_guard<mutex> guard(lock);
+    if (id >= names.size()) throw out_of_range("Edge name ID out of range");
+    return names[id];
+}
+
+// Function to get the number of names
+// Parameters: None.
+// Return value: The number of distinct names, the empty one included.
+inline size_t NameTable::size() const {
+    lock_guard<mutex> guard(lock);
+    return names.size();
+}
@@ -0,0 +1,65 @@
+/*
+QueryExecutor.hpp
+A file that contains the declaration of the QueryExecutor class, a thread pool for running route queries in parallel.
+Every worker thread owns a SearchContext and hands it to each job it runs, so jobs can search one shared, read-only
+graph (a CSRGraph or a ContractionHierarchy) at the same time without any locking on the search path.
+Written by: Khoi V.
+*/
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional> // for std::function
+#include <exception> // for std::exception_ptr
+#include <utility> // for std::pair
+#include "SearchContext.hpp"
+#include "CSRGraph.hpp"
+
+using namespace std;
+
+class QueryExecutor {
+private:
+    vector<thread> workers;
+    deque<function<void(SearchContext&)>> jobs; // jobs not yet started
+    mutex lock; // guards jobs, pending, stopping and failure
+    condition_variable wake; // signalled when a job is queued or the executor stops
+    condition_variable idle; // signalled when the last pending job finishes
+    size_t pending = 0; // jobs queued or running
+    bool stopping = false;
+    exception_ptr failure; // first exception thrown by a job since the last wait
+
+    // Loop run by every worker thread
+    void work();
+
+public:
+    // Starts the given number of worker threads (0 = one per hardware thread)
+    QueryExecutor(size_t threads = 0);
+    // Finishes the queued jobs and joins the workers
+    ~QueryExecutor();
+    // The executor owns threads, so it cannot be copied
+    QueryExecutor(const QueryExecutor&) = delete;
+    QueryExecutor& operator=(const QueryExecutor&) = delete;
+
+    // Number of worker threads
+    size_t numThreads() const;
+    // Queues a job; it runs on some worker with that worker's search context
+    void submit(function<void(SearchContext&)> job);
+    // Blocks until every submitted job has finished; rethrows the first exception a job threw
+    void wait();
+
+    // Runs a batch of (source, target) queries with bidirectional Dijkstra, spread over the workers
+    // Returns, for each query in order, the vertex indices of the path and its distance
+    template <typename T>
+    vector<pair<vector<size_t>, double>> route(const CSRGraph<T>& g, const vector<pair<size_t,size_t>>& queries);
+
+    // Computes the sources x targets distance matrix (row-major), one search per source spread over the workers
+    // If pred is given, it is filled with the vertex before each target on its shortest path
+    template <typename T>
+    void matrix(const CSRGraph<T>& g, const vector<size_t>& sources, const vector<size_t>& targets,
+                vector<double>& dist, vector<size_t>* pred = nullptr);
+};
+
+#include "QueryExecutor.tpp"
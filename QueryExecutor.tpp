@@ -0,0 +1,133 @@
+/*
+QueryExecutor.tpp
+A file that contains the implementation of the QueryExecutor class.
+Written by: Khoi V.
+*/
+#include "QueryExecutor.hpp"
+
+// Constructor
+// Parameters: threads - the number of worker threads, or 0 for one per hardware thread.
+// Return value: None.
+inline QueryExecutor::QueryExecutor(size_t threads) {
+    if (threads == 0) threads = thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+    for (size_t i = 0; i < threads; ++i) {
+        workers.emplace_back(&QueryExecutor::work, this);
+    }
+}
+
+// Destructor
+// Lets the workers finish the queued jobs, then joins them.
+// Parameters: None.
+// Return value: None.
+inline QueryExecutor::~QueryExecutor() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto &w : workers) w.join();
+}
+
+// Function run by every worker thread
+// Takes jobs off the queue until the executor stops and the queue is empty.
+// Parameters: None.
+// Return value: None.
+inline void QueryExecutor::work() {
+    SearchContext ctx;
+    while (true) {
+        function<void(SearchContext&)> job;
+        {
+            unique_lock<mutex> guard(lock);
+            wake.wait(guard, [this] { return stopping || !jobs.empty(); });
+            if (jobs.empty()) return;
+            job = move(jobs.front());
+            jobs.pop_front();
+        }
+        try {
+            job(ctx);
+        } catch (...) {
+            lock_guard<mutex> guard(lock);
+            if (!failure) failure = current_exception();
+        }
+        lock_guard<mutex> guard(lock);
+        if (--pending == 0) idle.notify_all();
+    }
+}
+
+// Function to get the number of worker threads
+// Parameters: None.
+// Return value: The number of worker threads.
+inline size_t QueryExecutor::numThreads() const {
+    return workers.size();
+}
+
+// Function to queue a job
+// Parameters: job - callable taking the worker's SearchContext.
+// Return value: None.
+inline void QueryExecutor::submit(function<void(SearchContext&)> job) {
+    {
+        lock_guard<mutex> guard(lock);
+        jobs.push_back(move(job));
+        pending++;
+    }
+    wake.notify_one();
+}
+
+// Function to wait for every submitted job
+// Parameters: None.
+// Return value: None.
+// If a job threw, the first exception is rethrown here (the other jobs still ran).
+inline void QueryExecutor::wait() {
+    unique_lock<mutex> guard(lock);
+    idle.wait(guard, [this] { return pending == 0; });
+    if (failure) {
+        exception_ptr e = failure;
+        failure = nullptr;
+        rethrow_exception(e);
+    }
+}
+
+// Function to run a batch of route queries in parallel
+// Parameters: g - the graph snapshot to search (must not change while the batch runs),
+// queries - (source, target) pairs of vertex indices.
+// Return value: For each query, in order, the path as vertex indices and its distance (empty and infinity if unreachable).
+// Queries are handed out in blocks, so each job amortises the queue overhead over several searches.
+template <typename T>
+vector<pair<vector<size_t>, double>> QueryExecutor::route(const CSRGraph<T>& g, const vector<pair<size_t,size_t>>& queries) {
+    vector<pair<vector<size_t>, double>> results(queries.size());
+    size_t block = max<size_t>(1, min<size_t>(64, queries.size() / (4 * numThreads()) + 1));
+    for (size_t begin = 0; begin < queries.size(); begin += block) {
+        size_t end = min(queries.size(), begin + block);
+        submit([&, begin, end](SearchContext& ctx) {
+            for (size_t i = begin; i < end; ++i) {
+                results[i].second = g.bidirectionalDijkstra(ctx, queries[i].first, queries[i].second, results[i].first);
+            }
+        });
+    }
+    wait();
+    return results;
+}
+
+// Function to compute a distance matrix in parallel
+// Parameters: g - the graph snapshot to search (must not change while the matrix is computed),
+// sources, targets - vertex indices of the rows and columns,
+// dist - resized to sources.size() * targets.size() and filled row-major: dist[i * targets.size() + j] is the
+// distance from sources[i] to targets[j] (infinity if unreachable),
+// pred - if not null, resized and filled the same way with the vertex before targets[j] on that path (NONE if none).
+// Return value: None.
+// Every source is one job running CSRGraph::oneToMany, which stops as soon as all targets are settled;
+// each job writes its own row, so no locking is needed.
+template <typename T>
+void QueryExecutor::matrix(const CSRGraph<T>& g, const vector<size_t>& sources, const vector<size_t>& targets,
+                           vector<double>& dist, vector<size_t>* pred) {
+    size_t m = targets.size();
+    dist.assign(sources.size() * m, numeric_limits<double>::infinity());
+    if (pred) pred->assign(sources.size() * m, CSRGraph<T>::NONE);
+    for (size_t i = 0; i < sources.size(); ++i) {
+        submit([&, i](SearchContext& ctx) {
+            g.oneToMany(ctx, sources[i], targets, dist.data() + i * m, pred ? pred->data() + i * m : nullptr);
+        });
+    }
+    wait();
+}
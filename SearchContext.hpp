@@ -0,0 +1,75 @@
+/*
+SearchContext.hpp
+A file that contains the declarations for the per-search state used by the graph searches.
+A SearchSpace holds the distance, parent and visited flag of every vertex for one search direction, plus its queue.
+Entries are stamped with the number of the search that wrote them, so starting a new search is O(1): entries with
+an old stamp read as "not reached" and are overwritten on first use. A SearchContext holds a forward and a backward
+SearchSpace; one context per thread lets many queries run at once against the same read-only graph, and reusing it
+between queries avoids allocating per-vertex arrays every time.
+Written by: Khoi V.
+*/
+#pragma once
+
+#include <vector>
+#include <cstdint> // for uint32_t
+#include <limits> // for std::numeric_limits
+#include "IndexedMinPriorityQueue.hpp"
+#include "SearchStats.hpp"
+
+using namespace std;
+
+class SearchSpace {
+private:
+    // State of one vertex in the current search
+    struct Entry {
+        double distance;
+        size_t parent;
+        uint32_t stamp; // search number that last wrote the entry
+        bool visited;
+    };
+    vector<Entry> entries;
+    uint32_t epoch = 0;
+
+    // Makes the entry of vertex i belong to the current search
+    Entry& touch(size_t i);
+
+public:
+    // Marks "no parent"
+    static constexpr size_t NONE = numeric_limits<size_t>::max();
+
+    // Queue of the search, keyed by vertex index
+    indexedMinPQ<double> pq;
+
+    // Starts a new search over the vertices 0..n-1
+    void reset(size_t n);
+    // Number of vertices the space covers
+    size_t size() const;
+
+    // Accessor and mutator methods; vertices not written by the current search read as
+    // distance infinity, parent NONE and not visited
+    double getDistance(size_t i) const;
+    void setDistance(size_t i, double d);
+    size_t getParent(size_t i) const;
+    void setParent(size_t i, size_t p);
+    bool isVisited(size_t i) const;
+    void setVisited(size_t i, bool v);
+    // True if vertex i was written by the current search
+    bool isReached(size_t i) const;
+
+    // Vertex indices from the root of the parent tree to target
+    vector<size_t> route(size_t target) const;
+};
+
+class SearchContext {
+public:
+    // Search from the source (and the only side used by one-directional searches)
+    SearchSpace forward;
+    // Search backwards from the target, used by bidirectional searches
+    SearchSpace backward;
+#ifdef ROUTE_STATS
+    // Counters and timers of the current query; searches add to them, the caller clears them between queries
+    QueryStats stats;
+#endif
+};
+
+#include "SearchContext.tpp"
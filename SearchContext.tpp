@@ -0,0 +1,109 @@
+/*
+SearchContext.tpp
+A file that contains the implementation of the SearchSpace class methods.
+Written by: Khoi V.
+*/
+#include "SearchContext.hpp"
+#include <algorithm> // for std::reverse
+
+// Function to claim the entry of a vertex for the current search
+// Parameters: i - the vertex index.
+// Return value: A reference to the entry, cleared if it was left over from an earlier search.
+inline SearchSpace::Entry& SearchSpace::touch(size_t i) {
+    Entry& e = entries[i];
+    if (e.stamp != epoch) {
+        e.distance = numeric_limits<double>::infinity();
+        e.parent = NONE;
+        e.stamp = epoch;
+        e.visited = false;
+    }
+    return e;
+}
+
+// Function to start a new search
+// Parameters: n - the number of vertices of the graph to search.
+// Return value: None.
+// Only the queue entries still present are cleared; per-vertex entries are invalidated by moving to the next stamp.
+inline void SearchSpace::reset(size_t n) {
+    if (n != entries.size()) {
+        entries.assign(n, Entry{0.0, NONE, 0, false});
+        epoch = 0;
+    }
+    // stamp 0 marks entries never written, so skip it; clear every stamp when the counter wraps around
+    if (++epoch == 0) {
+        for (auto &e : entries) e.stamp = 0;
+        epoch = 1;
+    }
+    pq.reset(n);
+}
+
+// Function to get the number of vertices the space covers
+// Parameters: None.
+// Return value: The number of vertices.
+inline size_t SearchSpace::size() const {
+    return entries.size();
+}
+
+// Function to get the distance of a vertex
+// Parameters: i - the vertex index.
+// Return value: The distance set by the current search, or infinity.
+inline double SearchSpace::getDistance(size_t i) const {
+    const Entry& e = entries[i];
+    return e.stamp == epoch ? e.distance : numeric_limits<double>::infinity();
+}
+
+// Function to set the distance of a vertex
+// Parameters: i - the vertex index, d - the distance.
+// Return value: None.
+inline void SearchSpace::setDistance(size_t i, double d) {
+    touch(i).distance = d;
+}
+
+// Function to get the parent of a vertex
+// Parameters: i - the vertex index.
+// Return value: The parent set by the current search, or NONE.
+inline size_t SearchSpace::getParent(size_t i) const {
+    const Entry& e = entries[i];
+    return e.stamp == epoch ? e.parent : NONE;
+}
+
+// Function to set the parent of a vertex
+// Parameters: i - the vertex index, p - the parent index.
+// Return value: None.
+inline void SearchSpace::setParent(size_t i, size_t p) {
+    touch(i).parent = p;
+}
+
+// Function to check whether a vertex has been visited
+// Parameters: i - the vertex index.
+// Return value: true if the current search marked the vertex visited.
+inline bool SearchSpace::isVisited(size_t i) const {
+    const Entry& e = entries[i];
+    return e.stamp == epoch && e.visited;
+}
+
+// Function to set the visited flag of a vertex
+// Parameters: i - the vertex index, v - the flag.
+// Return value: None.
+inline void SearchSpace::setVisited(size_t i, bool v) {
+    touch(i).visited = v;
+}
+
+// Function to check whether the current search wrote a vertex
+// Parameters: i - the vertex index.
+// Return value: true if the vertex has an entry from the current search.
+inline bool SearchSpace::isReached(size_t i) const {
+    return entries[i].stamp == epoch;
+}
+
+// Function to rebuild a route from the parent tree of the current search
+// Parameters: target - the last vertex of the route.
+// Return value: The vertex indices from the root of the tree to target, in order.
+inline vector<size_t> SearchSpace::route(size_t target) const {
+    vector<size_t> out;
+    for (size_t cur = target; cur != NONE; cur = getParent(cur)) {
+        out.push_back(cur);
+    }
+    reverse(out.begin(), out.end());
+    return out;
+}
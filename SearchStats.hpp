@@ -0,0 +1,133 @@
+/*
+SearchStats.hpp
+A file that contains the declarations of the opt-in search instrumentation.
+Compiling with -DROUTE_STATS turns it on: every SearchContext then carries the QueryStats of the query it is used for
+(vertices settled, edges relaxed, queue pushes and decrease-keys, and the time spent in each phase of the query), and
+finished queries are added to process-wide latency histograms, one per phase, which can be printed or dumped as JSON.
+Without ROUTE_STATS, SEARCH_STATS(...) expands to nothing and SearchContext has no stats member, so the searches
+compile exactly as before and pay nothing.
+The histograms have power-of-two buckets in microseconds and atomic counters, so concurrent queries can add to them
+without locking; percentiles read from them are the upper bound of the bucket they fall in.
+Written by: Khoi V.
+*/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint> // for uint64_t
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+// SEARCH_STATS(statement) runs the statement only in builds with ROUTE_STATS
+#ifdef ROUTE_STATS
+#define SEARCH_STATS(statement) statement
+#else
+#define SEARCH_STATS(statement)
+#endif
+
+// Phases of a route query
+enum class QueryPhase { SNAP, SEARCH, PATH, FORMAT, TOTAL };
+
+// Number of phases, TOTAL included
+static constexpr size_t QUERY_PHASES = 5;
+
+// Counters and timers of one query
+struct QueryStats {
+    size_t settled = 0; // vertices taken off the queues
+    size_t relaxed = 0; // edges scanned from settled vertices
+    size_t pushes = 0; // vertices inserted into the queues
+    size_t decreases = 0; // keys lowered in the queues
+    double phaseUs[QUERY_PHASES] = {0, 0, 0, 0, 0}; // time spent in each phase, in microseconds
+
+    // Zeroes every counter and timer, for the next query
+    void clear();
+    // Prints the counters and timers on one line
+    void print(ostream& out) const;
+};
+
+// Process-wide histogram of latencies
+class LatencyHistogram {
+public:
+    // Bucket 0 holds latencies under 1 us, bucket i those in [2^(i-1), 2^i) us; the last one everything longer
+    static constexpr size_t BUCKETS = 40;
+
+    // Adds one latency, in microseconds
+    void record(double us);
+    // Number of latencies recorded
+    uint64_t count() const;
+    // Number of latencies in bucket b
+    uint64_t bucket(size_t b) const;
+    // Mean latency in microseconds (0 if none)
+    double mean() const;
+    // Upper bound of the bucket holding the given fraction (0..1] of the latencies, in microseconds
+    double percentile(double fraction) const;
+    // Forgets every latency
+    void clear();
+
+private:
+    atomic<uint64_t> buckets[BUCKETS] = {};
+    atomic<uint64_t> total{0};
+    atomic<uint64_t> sumNs{0};
+};
+
+// Process-wide statistics: a latency histogram per phase and the counters of all queries
+class SearchStatsRegistry {
+public:
+    // The registry of the process
+    static SearchStatsRegistry& global();
+
+    // Adds a finished query: its phase times to the histograms and its counters to the totals
+    void record(const QueryStats& q);
+    // Prints the histograms as a table
+    void print(ostream& out) const;
+    // Writes the histograms and totals as one JSON object
+    void dump(ostream& out) const;
+    // Forgets everything recorded
+    void clear();
+
+    // Name of a phase, as printed
+    static const char* phaseName(size_t phase);
+
+private:
+    LatencyHistogram phases[QUERY_PHASES];
+    atomic<uint64_t> queries{0}, settled{0}, relaxed{0}, pushes{0}, decreases{0};
+};
+
+// Adds the time from its construction to stop() (or its destruction) to one phase of a QueryStats
+class PhaseTimer {
+public:
+    PhaseTimer(QueryStats& stats, QueryPhase phase);
+    ~PhaseTimer();
+
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+    // Ends the phase early
+    void stop();
+
+private:
+    QueryStats& stats;
+    size_t phase;
+    chrono::steady_clock::time_point start;
+    bool running = true;
+};
+
+// Covers one whole query: clears the stats when created; when destroyed, adds the total time, records the query
+// in the global registry and, if given a stream, prints its stats there
+class QueryScope {
+public:
+    QueryScope(QueryStats& stats, ostream* print = nullptr);
+    ~QueryScope();
+
+    QueryScope(const QueryScope&) = delete;
+    QueryScope& operator=(const QueryScope&) = delete;
+
+private:
+    QueryStats& stats;
+    ostream* print;
+    chrono::steady_clock::time_point start;
+};
+
+#include "SearchStats.tpp"
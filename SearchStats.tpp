@@ -0,0 +1,209 @@
+/*
+SearchStats.tpp
+A file that contains the implementation of the search instrumentation classes.
+Written by: Khoi V.
+*/
+#include "SearchStats.hpp"
+#include <iomanip> // for std::setw
+#include <cmath> // for std::ldexp
+
+// Function to reset the counters of a query
+// Parameters: None.
+// Return value: None.
+inline void QueryStats::clear() {
+    *this = QueryStats();
+}
+
+// Function to print the counters of a query
+// Parameters: out - the stream to print to.
+// Return value: None.
+inline void QueryStats::print(ostream& out) const {
+    out << "settled=" << settled << " relaxed=" << relaxed << " pushes=" << pushes << " decreases=" << decreases;
+    for (size_t p = 0; p < QUERY_PHASES; ++p) {
+        out << " " << SearchStatsRegistry::phaseName(p) << "=" << phaseUs[p] << "us";
+    }
+    out << endl;
+}
+
+// Function to add a latency
+// Parameters: us - the latency in microseconds.
+// Return value: None.
+inline void LatencyHistogram::record(double us) {
+    size_t b = 0;
+    // bucket = number of bits of the whole microseconds, so [2^(b-1), 2^b) lands in b
+    for (uint64_t whole = us < 1.0 ? 0 : static_cast<uint64_t>(us); whole > 0 && b + 1 < BUCKETS; whole >>= 1) ++b;
+    buckets[b].fetch_add(1, memory_order_relaxed);
+    total.fetch_add(1, memory_order_relaxed);
+    sumNs.fetch_add(static_cast<uint64_t>(us * 1000.0), memory_order_relaxed);
+}
+
+// Function to get the number of latencies
+// Parameters: None.
+// Return value: The number of latencies recorded.
+inline uint64_t LatencyHistogram::count() const {
+    return total.load(memory_order_relaxed);
+}
+
+// Function to get the size of a bucket
+// Parameters: b - the bucket number.
+// Return value: The number of latencies in the bucket.
+inline uint64_t LatencyHistogram::bucket(size_t b) const {
+    return buckets[b].load(memory_order_relaxed);
+}
+
+// Function to get the mean latency
+// Parameters: None.
+// Return value: The mean in microseconds, 0 if nothing was recorded.
+inline double LatencyHistogram::mean() const {
+    uint64_t n = count();
+    return n == 0 ? 0.0 : sumNs.load(memory_order_relaxed) / 1000.0 / n;
+}
+
+// Function to estimate a percentile
+// Parameters: fraction - the fraction of latencies at or below the result, in (0, 1].
+// Return value: The upper bound in microseconds of the bucket holding that rank, 0 if nothing was recorded.
+inline double LatencyHistogram::percentile(double fraction) const {
+    uint64_t n = count();
+    if (n == 0) return 0.0;
+    uint64_t rank = static_cast<uint64_t>(ceil(fraction * n)), seen = 0;
+    for (size_t b = 0; b < BUCKETS; ++b) {
+        seen += buckets[b].load(memory_order_relaxed);
+        if (seen >= rank) return ldexp(1.0, static_cast<int>(b));
+    }
+    return ldexp(1.0, static_cast<int>(BUCKETS - 1));
+}
+
+// Function to forget every latency
+// Parameters: None.
+// Return value: None.
+inline void LatencyHistogram::clear() {
+    for (auto &b : buckets) b.store(0, memory_order_relaxed);
+    total.store(0, memory_order_relaxed);
+    sumNs.store(0, memory_order_relaxed);
+}
+
+// Function to get the registry of the process
+// Parameters: None.
+// Return value: The registry, created on first use.
+inline SearchStatsRegistry& SearchStatsRegistry::global() {
+    static SearchStatsRegistry registry;
+    return registry;
+}
+
+// Function to add a finished query
+// Parameters: q - the counters and phase times of the query.
+// Return value: None.
+// Note: Safe to call from several threads at once.
+inline void SearchStatsRegistry::record(const QueryStats& q) {
+    for (size_t p = 0; p < QUERY_PHASES; ++p) {
+        phases[p].record(q.phaseUs[p]);
+    }
+    queries.fetch_add(1, memory_order_relaxed);
+    settled.fetch_add(q.settled, memory_order_relaxed);
+    relaxed.fetch_add(q.relaxed, memory_order_relaxed);
+    pushes.fetch_add(q.pushes, memory_order_relaxed);
+    decreases.fetch_add(q.decreases, memory_order_relaxed);
+}
+
+// Function to print the histograms
+// Parameters: out - the stream to print to.
+// Return value: None.
+inline void SearchStatsRegistry::print(ostream& out) const {
+    out << "Queries: " << queries.load() << ", settled: " << settled.load() << ", relaxed: " << relaxed.load()
+        << ", pushes: " << pushes.load() << ", decreases: " << decreases.load() << endl;
+    out << left << setw(8) << "phase" << right << setw(12) << "mean us" << setw(12) << "p50 us" << setw(12) << "p95 us"
+        << setw(12) << "p99 us" << endl;
+    for (size_t p = 0; p < QUERY_PHASES; ++p) {
+        out << left << setw(8) << phaseName(p) << right << setw(12) << phases[p].mean() << setw(12)
+            << phases[p].percentile(0.50) << setw(12) << phases[p].percentile(0.95) << setw(12)
+            << phases[p].percentile(0.99) << endl;
+    }
+}
+
+// Function to write the histograms as JSON
+// Parameters: out - the stream to write to.
+// Return value: None.
+// The object has the totals and, for each phase, the count, mean, percentiles and the bucket counts
+// (bucket i counts latencies under 2^i microseconds and at least 2^(i-1)).
+inline void SearchStatsRegistry::dump(ostream& out) const {
+    out << "{\"queries\":" << queries.load() << ",\"settled\":" << settled.load() << ",\"relaxed\":" << relaxed.load()
+        << ",\"pushes\":" << pushes.load() << ",\"decreases\":" << decreases.load() << ",\"phases\":{";
+    for (size_t p = 0; p < QUERY_PHASES; ++p) {
+        const LatencyHistogram& h = phases[p];
+        out << (p > 0 ? "," : "") << "\"" << phaseName(p) << "\":{\"count\":" << h.count() << ",\"mean_us\":" << h.mean()
+            << ",\"p50_us\":" << h.percentile(0.50) << ",\"p95_us\":" << h.percentile(0.95)
+            << ",\"p99_us\":" << h.percentile(0.99) << ",\"buckets\":[";
+        for (size_t b = 0; b < LatencyHistogram::BUCKETS; ++b) {
+            out << (b > 0 ? "," : "") << h.bucket(b);
+        }
+        out << "]}";
+    }
+    out << "}}" << endl;
+}
+
+// Function to forget everything recorded
+// Parameters: None.
+// Return value: None.
+inline void SearchStatsRegistry::clear() {
+    for (auto &h : phases) h.clear();
+    queries.store(0);
+    settled.store(0);
+    relaxed.store(0);
+    pushes.store(0);
+    decreases.store(0);
+}
+
+// Function to name a phase
+// Parameters: phase - the phase number.
+// Return value: The name of the phase.
+inline const char* SearchStatsRegistry::phaseName(size_t phase) {
+    static const char* const names[QUERY_PHASES] = {"snap", "search", "path", "format", "total"};
+    return names[phase];
+}
+
+// Constructor
+// Parameters: stats - the query to add the time to, phase - the phase to add it to.
+// Return value: None.
+inline PhaseTimer::PhaseTimer(QueryStats& stats, QueryPhase phase)
+    : stats(stats), phase(static_cast<size_t>(phase)), start(chrono::steady_clock::now()) {
+}
+
+// Destructor
+// Adds the time elapsed since construction to the phase.
+// Parameters: None.
+// Return value: None.
+inline PhaseTimer::~PhaseTimer() {
+    stop();
+}
+
+// Function to end the phase
+// Adds the time elapsed since construction to the phase, once.
+// Parameters: None.
+// Return value: None.
+inline void PhaseTimer::stop() {
+    if (!running) return;
+    running = false;
+    stats.phaseUs[phase] += chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+}
+
+// Constructor
+// Parameters: stats - the stats of the query, cleared here, print - where to print them at the end, or nullptr.
+// Return value: None.
+inline QueryScope::QueryScope(QueryStats& stats, ostream* print)
+    : stats(stats), print(print), start(chrono::steady_clock::now()) {
+    stats.clear();
+}
+
+// Destructor
+// Adds the total time of the query, records it in the global registry and prints it if asked to.
+// Parameters: None.
+// Return value: None.
+inline QueryScope::~QueryScope() {
+    stats.phaseUs[static_cast<size_t>(QueryPhase::TOTAL)] +=
+        chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+    SearchStatsRegistry::global().record(stats);
+    if (print != nullptr) {
+        *print << "Search stats: ";
+        stats.print(*print);
+    }
+}
@@ -0,0 +1,99 @@
+/*
+ShortestPathTreeCache.hpp
+A file that contains the declarations of the ShortestPathTree and ShortestPathTreeCache classes.
+A ShortestPathTree is the result of one full run of Dijkstra's algorithm, kept as compact arrays: the distance and
+the parent (as a 32-bit vertex index) of every vertex. Once the tree of a source is known, the route from that source
+to any vertex is read off the parent array in O(route length), so queries that share an origin skip the search.
+A ShortestPathTreeCache keeps the trees of the most recently used sources within a memory budget, evicting the
+least recently used tree first, and counts hits and misses. It is safe to use from several threads at once; trees
+are handed out as shared pointers, so a tree stays valid for its user even if the cache evicts it meanwhile.
+The owner must clear the cache whenever the graph changes (DirectedGraph does so on every mutation), except for
+changes of edge weights: those are passed to repair, which fixes every cached tree in place (dynamic SSSP). Only the
+vertices whose distance or parent can change are visited: the subtrees below edges that got heavier are cut off
+and re-attached from their unaffected in-neighbours, and a Dijkstra search seeded with those vertices and the heads
+of edges that got lighter spreads the improvements, stopping where distances no longer change.
+Written by: Khoi V.
+*/
+#pragma once
+
+#include <vector>
+#include <list>
+#include <memory> // for std::shared_ptr
+#include <mutex>
+#include <cstdint> // for uint32_t
+#include <unordered_map>
+#include <utility> // for std::pair
+#include "CSRGraph.hpp"
+#include "SearchContext.hpp"
+
+using namespace std;
+
+class ShortestPathTree {
+public:
+    // Marks the source and unreached vertices in parent
+    static constexpr uint32_t NONE = numeric_limits<uint32_t>::max();
+
+    size_t source;
+    vector<double> distance; // distance[v] = distance from the source to v, infinity if unreachable
+    vector<uint32_t> parent; // parent[v] = vertex before v on its shortest path, NONE for the source and unreached vertices
+
+    // Vertex indices from the source to target, empty if target is unreachable
+    vector<size_t> route(size_t target) const;
+    // Memory used by the tree, in bytes
+    size_t bytes() const;
+
+    // Updates the tree after the weights of the given edges of g changed (g is otherwise the graph the tree was
+    // computed on); returns the number of vertices visited
+    template <typename T>
+    size_t repair(const CSRGraph<T>& g, SearchContext& ctx, const vector<size_t>& changed);
+};
+
+class ShortestPathTreeCache {
+public:
+    // Counters since the cache was created
+    struct Stats {
+        size_t hits; // lookups answered from the cache
+        size_t misses; // lookups that ran Dijkstra's algorithm
+        size_t evictions; // trees dropped to stay within the budget
+        size_t trees; // trees held now
+        size_t bytes; // memory held now
+    };
+
+    // Cache holding at most budget bytes of trees (0 disables caching)
+    ShortestPathTreeCache(size_t budget = 0);
+
+    // The copy is an empty cache with the same budget (trees belong to one graph)
+    ShortestPathTreeCache(const ShortestPathTreeCache& c);
+    ShortestPathTreeCache& operator=(const ShortestPathTreeCache& c);
+
+    // Tree of the given source on graph g: from the cache, or computed with ctx and then cached;
+    // if hit is given, it is set to whether the tree came from the cache
+    // Note: g must be the graph the cached trees were computed on; clear the cache when it changes
+    template <typename T>
+    shared_ptr<const ShortestPathTree> get(const CSRGraph<T>& g, SearchContext& ctx, size_t source, bool* hit = nullptr);
+
+    // Repairs every cached tree after the weights of the given edges of g changed
+    template <typename T>
+    void repair(const CSRGraph<T>& g, SearchContext& ctx, const vector<size_t>& changed);
+
+    // Drops every tree (the counters are kept)
+    void clear();
+    // Sets the budget in bytes, evicting trees if needed; 0 disables caching
+    void setBudget(size_t budget);
+    size_t getBudget() const;
+    // Current counters
+    Stats stats() const;
+
+private:
+    mutable mutex lock; // guards everything below
+    size_t budget;
+    size_t used = 0;
+    list<shared_ptr<ShortestPathTree>> recent; // most recently used first
+    unordered_map<size_t, list<shared_ptr<ShortestPathTree>>::iterator> bySource;
+    Stats counters = {0, 0, 0, 0, 0};
+
+    // Drops least recently used trees until at most limit bytes are held (lock must be held)
+    void shrink(size_t limit);
+};
+
+#include "ShortestPathTreeCache.tpp"
@@ -0,0 +1,258 @@
+/*
+ShortestPathTreeCache.tpp
+A file that contains the implementation of the ShortestPathTree and ShortestPathTreeCache classes.
+Written by: Khoi V.
+*/
+#include "ShortestPathTreeCache.hpp"
+#include <algorithm> // for std::reverse
+#include <stdexcept> // for std::out_of_range, std::length_error
+
+// Function to rebuild a route from the tree
+// Parameters: target - the index of the last vertex of the route.
+// Return value: The vertex indices from the source to target, in order; empty if target is unreachable.
+inline vector<size_t> ShortestPathTree::route(size_t target) const {
+    vector<size_t> out;
+    if (distance[target] == numeric_limits<double>::infinity()) return out;
+    for (size_t cur = target; cur != NONE; cur = parent[cur]) {
+        out.push_back(cur);
+    }
+    reverse(out.begin(), out.end());
+    return out;
+}
+
+// Function to get the memory used by the tree
+// Parameters: None.
+// Return value: The size of the tree in bytes.
+inline size_t ShortestPathTree::bytes() const {
+    return sizeof(ShortestPathTree) + distance.capacity() * sizeof(double) + parent.capacity() * sizeof(uint32_t);
+}
+
+// Function to repair the tree after edge weight changes
+// Description: 1) Every edge that got heavier and was the tree edge into its head cuts off the subtree of the head;
+// those vertices lose their distances, and each takes the best one offered by an in-neighbour outside the cut.
+// 2) Every edge that got lighter and now shortens the path to its head lowers the head's distance.
+// 3) Dijkstra's algorithm, started from the vertices changed in 1) and 2), lowers the distances below them until
+// none improves. Vertices outside the cut subtrees and away from the improvements are never visited.
+// Parameters: g - the graph with the new weights, ctx - the search context to use (its forward space marks the cut),
+// changed - the indices of the edges whose weights changed (in any order, repeats allowed).
+// Return value: The number of vertices whose entries were reset or taken off the queue.
+// Note: Distances equal those of a fresh Dijkstra search, though a tie may be broken with another parent.
+template <typename T>
+size_t ShortestPathTree::repair(const CSRGraph<T>& g, SearchContext& ctx, const vector<size_t>& changed) {
+    const double INF = numeric_limits<double>::infinity();
+    SearchSpace& cut = ctx.forward;
+    cut.reset(g.numVertices());
+    size_t visited = 0;
+
+    // 1) cut off the subtrees below tree edges that got heavier
+    vector<size_t> subtree, stack;
+    for (size_t e : changed) {
+        size_t a = g.edgeSource(e), b = g.edgeTarget(e);
+        if (parent[b] != a || cut.isVisited(b) || distance[b] >= distance[a] + g.edgeWeight(e)) continue;
+        cut.setVisited(b, true);
+        stack.push_back(b);
+        while (!stack.empty()) {
+            size_t x = stack.back();
+            stack.pop_back();
+            subtree.push_back(x);
+            for (size_t f = g.edgeBegin(x); f < g.edgeEnd(x); ++f) {
+                size_t y = g.edgeTarget(f);
+                if (parent[y] == x && !cut.isVisited(y)) {
+                    cut.setVisited(y, true);
+                    stack.push_back(y);
+                }
+            }
+        }
+    }
+    for (size_t x : subtree) {
+        distance[x] = INF;
+        parent[x] = NONE;
+    }
+    // re-attach each cut vertex to its best in-neighbour outside the cut
+    for (size_t x : subtree) {
+        for (size_t k = g.inEdgeBegin(x); k < g.inEdgeEnd(x); ++k) {
+            size_t u = g.inEdgeSource(k);
+            double alt = distance[u] + g.edgeWeight(g.inEdge(k));
+            if (!cut.isVisited(u) && alt < distance[x]) {
+                distance[x] = alt;
+                parent[x] = static_cast<uint32_t>(u);
+            }
+        }
+        if (distance[x] < INF) cut.pq.insertOrDecrease(distance[x], x);
+    }
+    visited += subtree.size();
+
+    // 2) edges that got lighter
+    for (size_t e : changed) {
+        size_t a = g.edgeSource(e), b = g.edgeTarget(e);
+        double alt = distance[a] + g.edgeWeight(e);
+        if (alt < distance[b]) {
+            distance[b] = alt;
+            parent[b] = static_cast<uint32_t>(a);
+            cut.pq.insertOrDecrease(alt, b);
+        }
+    }
+
+    // 3) spread the new distances
+    while (!cut.pq.empty()) {
+        auto [dx, x] = cut.pq.pop();
+        ++visited;
+        for (size_t f = g.edgeBegin(x); f < g.edgeEnd(x); ++f) {
+            size_t y = g.edgeTarget(f);
+            double alt = dx + g.edgeWeight(f);
+            if (alt < distance[y]) {
+                distance[y] = alt;
+                parent[y] = static_cast<uint32_t>(x);
+                cut.pq.insertOrDecrease(alt, y);
+            }
+        }
+    }
+    return visited;
+}
+
+// Constructor
+// Parameters: budget - the most memory the trees may use, in bytes; 0 disables caching.
+// Return value: None.
+inline ShortestPathTreeCache::ShortestPathTreeCache(size_t budget) : budget(budget) {
+}
+
+// Copy constructor
+// Parameters: c - the cache to copy the budget of.
+// Return value: None.
+inline ShortestPathTreeCache::ShortestPathTreeCache(const ShortestPathTreeCache& c) : budget(c.getBudget()) {
+}
+
+// Assignment operator
+// Parameters: c - the cache to copy the budget of.
+// Return value: A reference to this cache, emptied.
+// Note: Dropped trees are not counted as evictions.
+inline ShortestPathTreeCache& ShortestPathTreeCache::operator=(const ShortestPathTreeCache& c) {
+    if (this != &c) {
+        size_t b = c.getBudget();
+        lock_guard<mutex> guard(lock);
+        budget = b;
+        recent.clear();
+        bySource.clear();
+        used = 0;
+    }
+    return *this;
+}
+
+// Function to get the shortest-path tree of a source
+// Description: On a hit the tree moves to the front of the LRU list. On a miss Dijkstra's algorithm runs over the whole
+// graph (outside the lock, so other threads keep using the cache), the tree is packed into compact arrays and, if it
+// fits in the budget, cached, evicting the least recently used trees to make room.
+// Parameters: g - the graph, ctx - the search context used on a miss, source - the index of the source vertex,
+// hit - if not null, set to true if the tree came from the cache and false if it was computed.
+// Return value: The tree of source.
+// It throws std::out_of_range if source is not a vertex of g, and std::length_error if g has too many vertices
+// for 32-bit parents.
+template <typename T>
+shared_ptr<const ShortestPathTree> ShortestPathTreeCache::get(const CSRGraph<T>& g, SearchContext& ctx, size_t source, bool* hit) {
+    if (source >= g.numVertices()) throw out_of_range("Vertex index out of range");
+    if (g.numVertices() >= ShortestPathTree::NONE) throw length_error("Graph too large for a shortest-path tree");
+    if (hit != nullptr) *hit = false;
+    {
+        lock_guard<mutex> guard(lock);
+        auto it = bySource.find(source);
+        if (it != bySource.end()) {
+            counters.hits++;
+            if (hit != nullptr) *hit = true;
+            recent.splice(recent.begin(), recent, it->second);
+            return *it->second;
+        }
+        counters.misses++;
+    }
+
+    g.Dijkstra(ctx, source);
+    size_t n = g.numVertices();
+    shared_ptr<ShortestPathTree> tree(new ShortestPathTree);
+    tree->source = source;
+    tree->distance.resize(n);
+    tree->parent.resize(n);
+    for (size_t v = 0; v < n; ++v) {
+        tree->distance[v] = ctx.forward.getDistance(v);
+        size_t p = ctx.forward.getParent(v);
+        tree->parent[v] = p == SearchSpace::NONE ? ShortestPathTree::NONE : static_cast<uint32_t>(p);
+    }
+
+    lock_guard<mutex> guard(lock);
+    size_t size = tree->bytes();
+    // another thread may have cached the same source while this one was searching
+    if (size <= budget && bySource.find(source) == bySource.end()) {
+        shrink(budget - size);
+        recent.push_front(tree);
+        bySource[source] = recent.begin();
+        used += size;
+    }
+    return tree;
+}
+
+// Function to repair the cached trees after edge weight changes
+// Description: A tree nobody else holds is repaired in place; a tree still in use elsewhere is copied first,
+// so the holder keeps the tree it was given.
+// Parameters: g - the graph with the new weights, ctx - the search context to use,
+// changed - the indices of the edges whose weights changed.
+// Return value: None.
+template <typename T>
+void ShortestPathTreeCache::repair(const CSRGraph<T>& g, SearchContext& ctx, const vector<size_t>& changed) {
+    lock_guard<mutex> guard(lock);
+    for (auto &tree : recent) {
+        if (tree.use_count() > 1) {
+            tree = make_shared<ShortestPathTree>(*tree);
+        }
+        tree->repair(g, ctx, changed);
+    }
+}
+
+// Function to drop least recently used trees
+// Parameters: limit - the most memory to keep, in bytes.
+// Return value: None.
+// Note: The caller must hold the lock.
+inline void ShortestPathTreeCache::shrink(size_t limit) {
+    while (used > limit && !recent.empty()) {
+        used -= recent.back()->bytes();
+        bySource.erase(recent.back()->source);
+        recent.pop_back();
+        counters.evictions++;
+    }
+}
+
+// Function to drop every tree
+// Parameters: None.
+// Return value: None.
+// Note: Dropped trees are not counted as evictions.
+inline void ShortestPathTreeCache::clear() {
+    lock_guard<mutex> guard(lock);
+    recent.clear();
+    bySource.clear();
+    used = 0;
+}
+
+// Function to set the memory budget
+// Parameters: b - the most memory the trees may use, in bytes; 0 disables caching.
+// Return value: None.
+inline void ShortestPathTreeCache::setBudget(size_t b) {
+    lock_guard<mutex> guard(lock);
+    budget = b;
+    shrink(budget);
+}
+
+// Function to get the memory budget
+// Parameters: None.
+// Return value: The budget in bytes.
+inline size_t ShortestPathTreeCache::getBudget() const {
+    lock_guard<mutex> guard(lock);
+    return budget;
+}
+
+// Function to get the counters
+// Parameters: None.
+// Return value: The hit, miss and eviction counts and the trees and bytes held now.
+inline ShortestPathTreeCache::Stats ShortestPathTreeCache::stats() const {
+    lock_guard<mutex> guard(lock);
+    Stats s = counters;
+    s.trees = recent.size();
+    s.bytes = used;
+    return s;
+}
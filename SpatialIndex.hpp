@@ -0,0 +1,83 @@
+/*
+SpatialIndex.hpp
+A file that contains the declaration of the SpatialIndex class, a static bounding-box tree for nearest-neighbour queries.
+The index holds either points (the vertices of a graph) or segments (its edges). It is built once by splitting the
+items at the median of their centres, alternating on the wider side, and every node keeps the bounding box of its
+items; a query walks the tree nearest box first and skips every box farther than the best match found so far,
+which takes O(log n) time on road maps.
+Distances are Euclidean after multiplying x by a constant xScale. For (longitude, latitude) coordinates, xScale =
+cos(latitude) of the area (see lonScale) makes a degree of longitude as long as a degree of latitude, so the
+nearest item is the nearest on the ground for any map that is not continent-sized.
+Written by: Khoi V.
+*/
+#pragma once
+
+#include <vector>
+#include <utility> // for std::pair
+#include <cstdint> // for uint32_t
+#include "CSRGraph.hpp"
+
+using namespace std;
+
+class SpatialIndex {
+public:
+    // An item found by a query
+    struct Match {
+        size_t id; // vertex index for a point index, edge index for an edge index; NONE if the index is empty
+        double distance; // distance from the query point, in scaled coordinate units
+        pair<double,double> point; // the point of the item nearest to the query
+        double fraction; // where point lies along the edge, 0 at its tail and 1 at its head (0 for vertices)
+    };
+
+    // Marks "no item"
+    static constexpr size_t NONE = numeric_limits<size_t>::max();
+
+    // Empty index
+    SpatialIndex(void);
+    // Index of the points coords[0..n-1], with ids 0..n-1
+    SpatialIndex(const pair<double,double>* coords, size_t n, double xScale = 1.0);
+    // Index of the edges of g, with edge indices as ids; coords[i] = (x,y) of vertex i of g
+    template <typename T>
+    SpatialIndex(const CSRGraph<T>& g, const pair<double,double>* coords, double xScale = 1.0);
+
+    // Number of items
+    size_t size(void) const;
+    // The item nearest to (x,y)
+    Match nearest(double x, double y) const;
+    // The k items nearest to (x,y), nearest first (fewer if the index has fewer items)
+    vector<Match> nearest(double x, double y, size_t k) const;
+
+    // xScale for (longitude, latitude) coordinates: the cosine of the middle latitude of the points
+    static double lonScale(const pair<double,double>* coords, size_t n);
+
+private:
+    // A point (a == b) or a segment from a to b
+    struct Item {
+        pair<double,double> a, b;
+        size_t id;
+    };
+    // A node of the tree covers items [begin, end); a leaf has no children
+    struct Node {
+        double minX, minY, maxX, maxY; // bounding box of the items
+        uint32_t begin, end;
+        uint32_t left, right; // child nodes, LEAF for a leaf
+    };
+    static constexpr uint32_t LEAF = numeric_limits<uint32_t>::max();
+    // Leaves hold at most this many items
+    static constexpr size_t LEAF_SIZE = 8;
+
+    vector<Item> items; // in tree order
+    vector<Node> nodes; // nodes[0] is the root
+    double xScale = 1.0;
+
+    // Builds the subtree over items [begin, end) and returns its node
+    uint32_t build(uint32_t begin, uint32_t end);
+    // Distance from (x,y) to the box of a node (0 inside it)
+    double boxDistance(const Node& node, double x, double y) const;
+    // Distance from (x,y) to an item
+    Match measure(const Item& item, double x, double y) const;
+    // Adds the items of the subtree that beat the k best so far (a max-heap on distance) to best
+    void search(uint32_t node, double x, double y, size_t k, vector<Match>& best) const;
+};
+
+#include "SpatialIndex.tpp"
@@ -0,0 +1,168 @@
+/*
+SpatialIndex.tpp
+A file that contains the implementation of the SpatialIndex class.
+Written by: Khoi V.
+*/
+#include "SpatialIndex.hpp"
+#include <algorithm> // for std::nth_element, std::push_heap, std::pop_heap, std::sort_heap
+#include <cmath>
+
+// Default constructor
+// Parameters: None.
+// Return value: None.
+inline SpatialIndex::SpatialIndex(void) {
+}
+
+// Constructor for a point index
+// Parameters: coords - array of n points, n - the number of points, xScale - factor applied to x distances.
+// Return value: None.
+inline SpatialIndex::SpatialIndex(const pair<double,double>* coords, size_t n, double xScale) : xScale(xScale) {
+    items.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        items.push_back(Item{coords[i], coords[i], i});
+    }
+    if (n > 0) build(0, static_cast<uint32_t>(n));
+}
+
+// Constructor for an edge index
+// Parameters: g - the graph, coords - coordinates of the vertices of g by index, xScale - factor applied to x distances.
+// Return value: None.
+template <typename T>
+SpatialIndex::SpatialIndex(const CSRGraph<T>& g, const pair<double,double>* coords, double xScale) : xScale(xScale) {
+    items.reserve(g.numEdges());
+    for (size_t u = 0; u < g.numVertices(); ++u) {
+        for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); ++e) {
+            items.push_back(Item{coords[u], coords[g.edgeTarget(e)], e});
+        }
+    }
+    if (!items.empty()) build(0, static_cast<uint32_t>(items.size()));
+}
+
+// Function to build a subtree
+// Description: Computes the bounding box of the items, then splits them at the median centre along the wider side.
+// Parameters: begin, end - the range of items.
+// Return value: The index of the subtree's root in nodes.
+inline uint32_t SpatialIndex::build(uint32_t begin, uint32_t end) {
+    Node node{numeric_limits<double>::infinity(), numeric_limits<double>::infinity(),
+              -numeric_limits<double>::infinity(), -numeric_limits<double>::infinity(), begin, end, LEAF, LEAF};
+    for (uint32_t i = begin; i < end; ++i) {
+        const Item& it = items[i];
+        node.minX = min(node.minX, min(it.a.first, it.b.first));
+        node.maxX = max(node.maxX, max(it.a.first, it.b.first));
+        node.minY = min(node.minY, min(it.a.second, it.b.second));
+        node.maxY = max(node.maxY, max(it.a.second, it.b.second));
+    }
+    uint32_t at = static_cast<uint32_t>(nodes.size());
+    nodes.push_back(node);
+    if (end - begin <= LEAF_SIZE) return at;
+
+    // centres are compared doubled (a + b) to avoid the division
+    bool alongX = (node.maxX - node.minX) * xScale >= node.maxY - node.minY;
+    uint32_t mid = begin + (end - begin) / 2;
+    nth_element(items.begin() + begin, items.begin() + mid, items.begin() + end, [alongX](const Item& p, const Item& q) {
+        return alongX ? p.a.first + p.b.first < q.a.first + q.b.first : p.a.second + p.b.second < q.a.second + q.b.second;
+    });
+    uint32_t left = build(begin, mid);
+    uint32_t right = build(mid, end);
+    nodes[at].left = left;
+    nodes[at].right = right;
+    return at;
+}
+
+// Function to get the number of items
+// Parameters: None.
+// Return value: The number of points or edges indexed.
+inline size_t SpatialIndex::size(void) const {
+    return items.size();
+}
+
+// Function to measure the distance to a box
+// Parameters: node - the node whose box to use, x, y - the query point.
+// Return value: The scaled distance from (x,y) to the nearest point of the box, 0 if (x,y) is inside it.
+inline double SpatialIndex::boxDistance(const Node& node, double x, double y) const {
+    double dx = max(0.0, max(node.minX - x, x - node.maxX)) * xScale;
+    double dy = max(0.0, max(node.minY - y, y - node.maxY));
+    return sqrt(dx * dx + dy * dy);
+}
+
+// Function to measure the distance to an item
+// Description: Projects (x,y) onto the segment in scaled coordinates and clamps the projection to the segment.
+// Parameters: item - the point or segment, x, y - the query point.
+// Return value: The match for the item: its id, distance, nearest point and the fraction along it.
+inline SpatialIndex::Match SpatialIndex::measure(const Item& item, double x, double y) const {
+    double sx = (item.b.first - item.a.first) * xScale, sy = item.b.second - item.a.second;
+    double px = (x - item.a.first) * xScale, py = y - item.a.second;
+    double len2 = sx * sx + sy * sy;
+    double f = len2 > 0 ? min(1.0, max(0.0, (px * sx + py * sy) / len2)) : 0.0;
+    // the ends are returned exactly, so a query on a vertex gets the vertex back
+    pair<double,double> point = f == 0.0 ? item.a : f == 1.0 ? item.b
+        : make_pair(item.a.first + f * (item.b.first - item.a.first), item.a.second + f * (item.b.second - item.a.second));
+    double dx = (x - point.first) * xScale, dy = y - point.second;
+    return Match{item.id, sqrt(dx * dx + dy * dy), point, f};
+}
+
+// Function to search a subtree
+// Parameters: node - the root of the subtree, x, y - the query point, k - the number of matches wanted,
+// best - max-heap on distance of the (at most k) best matches so far, updated in place.
+// Return value: None.
+inline void SpatialIndex::search(uint32_t node, double x, double y, size_t k, vector<Match>& best) const {
+    auto farther = [](const Match& p, const Match& q) { return p.distance < q.distance; };
+    const Node& n = nodes[node];
+    if (n.left == LEAF) {
+        for (uint32_t i = n.begin; i < n.end; ++i) {
+            Match m = measure(items[i], x, y);
+            if (best.size() < k) {
+                best.push_back(m);
+                push_heap(best.begin(), best.end(), farther);
+            } else if (m.distance < best.front().distance) {
+                pop_heap(best.begin(), best.end(), farther);
+                best.back() = m;
+                push_heap(best.begin(), best.end(), farther);
+            }
+        }
+        return;
+    }
+    // visit the nearer child first, so the farther one is more likely to be skipped
+    uint32_t first = n.left, second = n.right;
+    double d1 = boxDistance(nodes[first], x, y), d2 = boxDistance(nodes[second], x, y);
+    if (d2 < d1) {
+        swap(first, second);
+        swap(d1, d2);
+    }
+    if (best.size() < k || d1 < best.front().distance) search(first, x, y, k, best);
+    if (best.size() < k || d2 < best.front().distance) search(second, x, y, k, best);
+}
+
+// Function to find the nearest item
+// Parameters: x, y - the query point.
+// Return value: The nearest item; if the index is empty, a match with id NONE and distance infinity.
+inline SpatialIndex::Match SpatialIndex::nearest(double x, double y) const {
+    vector<Match> best = nearest(x, y, 1);
+    if (best.empty()) return Match{NONE, numeric_limits<double>::infinity(), make_pair(x, y), 0.0};
+    return best[0];
+}
+
+// Function to find the k nearest items
+// Parameters: x, y - the query point, k - the number of items wanted.
+// Return value: The min(k, size()) nearest items, nearest first.
+inline vector<SpatialIndex::Match> SpatialIndex::nearest(double x, double y, size_t k) const {
+    vector<Match> best;
+    if (k == 0 || items.empty()) return best;
+    best.reserve(min(k, items.size()));
+    search(0, x, y, k, best);
+    sort_heap(best.begin(), best.end(), [](const Match& p, const Match& q) { return p.distance < q.distance; });
+    return best;
+}
+
+// Function to compute xScale for (longitude, latitude) coordinates
+// Parameters: coords - array of n (longitude, latitude) points in degrees, n - the number of points.
+// Return value: The cosine of the latitude halfway between the southernmost and northernmost points (1 if n is 0).
+inline double SpatialIndex::lonScale(const pair<double,double>* coords, size_t n) {
+    if (n == 0) return 1.0;
+    double lo = coords[0].second, hi = coords[0].second;
+    for (size_t i = 1; i < n; ++i) {
+        lo = min(lo, coords[i].second);
+        hi = max(hi, coords[i].second);
+    }
+    return cos((lo + hi) / 2 * M_PI / 180.0);
+}
@@ -5,6 +5,8 @@ The Vertex class represents a vertex in a graph and contains methods for managin
 It includes methods for setting and getting the vertex value, visited status, distance, finish time, parent vertex, and adjacency list.
 The class also provides methods for adding and removing edges to the adjacency list.
 It is designed to be used with various data types, as indicated by the template parameter T.
+The edge weights have type W (double by default); float, or an integer type holding fixed-point weights, makes
+every edge smaller. WeightTraits<W> says what a stored weight stands for. Edge names are interned in NameTable::global(), so an edge holds a 32-bit name ID.
 Written by: Duc T.
 */
 
@@ -15,30 +17,64 @@ Written by: Duc T.
 #include <stdexcept> // for std::runtime_error
 #include <limits> // for std::numeric_limits
 #include <string> // for std::string
+#include <unordered_map> // for std::unordered_map
+#include <memory_resource> // for std::pmr::vector, std::pmr::memory_resource
+#include <string_view> // for std::string_view
+#include <cstdint> // for uint32_t
+#include <ratio> // for std::ratio, std::milli
+#include <type_traits> // for std::conditional_t, std::is_integral
+#include "NameTable.hpp"
 
 #pragma once
 
 using namespace std;
 
-template <typename T>
+// How a stored edge weight of type W stands for a real weight: the stored value times scale
+// Floating-point types hold the weight itself; integral types hold a fixed-point weight in thousandths, so a uint32_t
+// covers weights up to about 4.3 million. Specialize it to pick another scale for a type.
+template <typename W>
+struct WeightTraits {
+    using scale = conditional_t<is_integral<W>::value, milli, ratio<1>>;
+
+    // Real weight w as a stored weight, rounded to the nearest unit of scale for integral W
+    // Throws std::out_of_range if it does not fit W (a negative weight for an unsigned W, say)
+    static W toWeight(double w);
+
+    // Real weight a stored weight stands for
+    static double toDouble(W w);
+};
+
+template <typename T, typename W = double>
 class Vertex {
+    public:
+    // An edge: its head, its weight and the ID of its name in NameTable::global()
+    using Edge = tuple <Vertex<T, W>*, W, uint32_t>;
+
     private:
     T value;
     bool visited = false;
     double distance = numeric_limits<double>::infinity();
     int finishTime;
-    Vertex<T>* parent = nullptr;
-    vector<tuple <Vertex<T>*, double, string>> adjacencyList; // adjacency list for the vertex
+    Vertex<T, W>* parent = nullptr;
+    size_t index = 0; // position of the vertex in its graph's vertex list
+    pmr::vector<Edge> adjacencyList; // adjacency list for the vertex
+    unordered_map<Vertex<T, W>*, size_t> edgeIndex; // edgeIndex[v] = position in adjacencyList of the first edge to v,
+                                                  // built on the first lookup so that loading a graph skips it
+    pmr::vector<Vertex<T, W>*> incoming; // tails of the edges into this vertex, one entry per edge (reverse adjacency)
+
+    // Build the edge index if it is not built yet
+    void indexEdges();
 
     public:
     // Default constructor
-    Vertex(T val);
+    // The adjacency list and reverse adjacency are allocated from memory (the heap by default; a graph passes its arena)
+    Vertex(T val, pmr::memory_resource* memory = pmr::get_default_resource());
 
-    // Copy constructor
-    Vertex(const Vertex<T>& v);
+    // Copy constructor (the edges are not copied)
+    Vertex(const Vertex<T, W>& v, pmr::memory_resource* memory = pmr::get_default_resource());
 
     // Assignment operator
-    Vertex<T>& operator=(const Vertex<T>& v);
+    Vertex<T, W>& operator=(const Vertex<T, W>& v);
 
     // Destructor
     ~Vertex();
@@ -60,17 +96,46 @@ class Vertex {
 
     void setFinishTime(int time);
 
-    Vertex<T>* getParent();
+    Vertex<T, W>* getParent();
+
+    void setParent(Vertex<T, W>* p);
+
+    size_t getIndex();
 
-    void setParent(Vertex<T>* p);
+    void setIndex(size_t i);
+
+    // Where the adjacency list and reverse adjacency are allocated
+    pmr::memory_resource* getMemory();
+
+    // Make room for the given numbers of outgoing and incoming edges, so adding them allocates nothing
+    void reserveEdges(size_t outgoing, size_t incomingEdges);
 
     // Add and remove edges to the adjacency list
-    void addEdge(Vertex<T>* v, double w = 1.0, string name = "");
+    void addEdge(Vertex<T, W>* v, W w = W(1), string_view name = "");
+
+    // Same for a name already interned in NameTable::global(), given by its ID
+    void addInternedEdge(Vertex<T, W>* v, W w, uint32_t nameId);
+
+    void removeEdge(Vertex<T, W>* v);
 
-    void removeEdge(Vertex<T>* v);
+    // Edge lookup in O(1) through the edge index
+    bool hasEdge(Vertex<T, W>* v);
+
+    // Set the weight of the first edge to v, returning its position in the adjacency list
+    size_t setEdgeWeight(Vertex<T, W>* v, W w);
+
+    // Name of an edge of the adjacency list
+    static const string& edgeName(const Edge& e);
+
+    // Weight read as a double (from a file, say) converted to W with WeightTraits<W>::toWeight
+    static W toWeight(double w);
 
     // Getters for adjacency list
-    vector<tuple <Vertex<T>*, double, string>>& getAdjacencyList();
+    // Note: Entries must only be added or removed through addEdge and removeEdge, which keep the edge index in step
+    pmr::vector<Edge>& getAdjacencyList();
+
+    // Getter for the reverse adjacency: the tails of the edges into this vertex, one entry per edge
+    const pmr::vector<Vertex<T, W>*>& getIncoming();
 };
 
 #include "Vertex.tpp"
\ No newline at end of file
@@ -11,6 +11,7 @@ Written by: Duc T.
 #include <vector>
 #include <cmath>
 #include <stdexcept>
+#include <type_traits> // for std::is_integral
 #include "Vertex.hpp"
 
 using namespace std;
@@ -18,10 +19,11 @@ using namespace std;
 // Default constructor
 // Initializes the vertex with a value and sets default properties
 // Parameters: - val: The value to be assigned to the vertex.
+// - memory: Where the adjacency list and reverse adjacency are allocated (the heap by default).
 // The default properties are: visited = false, distance = 0.0, parent = nullptr, finishTime = 0.
 // Return value: None.
-template <typename T>
-Vertex<T>::Vertex(T val) {
+template <typename T, typename W>
+Vertex<T, W>::Vertex(T val, pmr::memory_resource* memory) : adjacencyList(memory), incoming(memory) {
     value = val;
     visited = false;
     distance = 0.0;
@@ -32,15 +34,17 @@ Vertex<T>::Vertex(T val) {
 // Copy constructor
 // Initializes a new vertex as a copy of an existing vertex.
 // Parameters: - v: The vertex to be copied.
-// The new vertex will have the same properties as the copied vertex.
+// - memory: Where the adjacency list and reverse adjacency of the copy are allocated (the heap by default).
+// The new vertex will have the same properties as the copied vertex, but no edges.
 // Return value: None.
-template <typename T>
-Vertex<T>::Vertex(const Vertex<T>& v) {
+template <typename T, typename W>
+Vertex<T, W>::Vertex(const Vertex<T, W>& v, pmr::memory_resource* memory) : adjacencyList(memory), incoming(memory) {
     value = v.value;
     visited = v.visited;
     distance = v.distance;
     parent = v.parent;
     finishTime = v.finishTime;
+    index = v.index;
 }
 
 // Assignment operator
@@ -49,14 +53,15 @@ Vertex<T>::Vertex(const Vertex<T>& v) {
 // The current vertex will take on the properties of the assigned vertex.
 // Return value: A reference to the current vertex.
 // This allows for chaining of assignment operations.
-template <typename T>
-Vertex<T>& Vertex<T>::operator=(const Vertex<T>& v) {
+template <typename T, typename W>
+Vertex<T, W>& Vertex<T, W>::operator=(const Vertex<T, W>& v) {
     if (this != &v) {
         value = v.value;
         visited = v.visited;
         distance = v.distance;
         parent = v.parent;
         finishTime = v.finishTime;
+        index = v.index;
     }
     return *this;
 }
@@ -67,8 +72,8 @@ Vertex<T>& Vertex<T>::operator=(const Vertex<T>& v) {
 // Return value: None.
 // The destructor does not need to do anything special in this case,
 // as the vertex does not manage any dynamic memory.
-template <typename T>
-Vertex<T>::~Vertex(void) {
+template <typename T, typename W>
+Vertex<T, W>::~Vertex(void) {
 
 }
 
@@ -77,64 +82,64 @@ Vertex<T>::~Vertex(void) {
 // Get the value of the vertex
 // Parameters: None.
 // Return value: The value of the vertex.
-template <typename T>
-T Vertex<T>::getValue() {
+template <typename T, typename W>
+T Vertex<T, W>::getValue() {
     return value;
 }
 
 // Set the value of the vertex
 // Parameters: - val: The value to be assigned to the vertex.
 // Return value: None.
-template <typename T>
-void Vertex<T>::setValue(T val) {
+template <typename T, typename W>
+void Vertex<T, W>::setValue(T val) {
     value = val;
 }
 
 // Check if the vertex has been visited
 // Parameters: None.
 // Return value: true if the vertex has been visited, false otherwise.
-template <typename T>
-bool Vertex<T>::isVisited() {
+template <typename T, typename W>
+bool Vertex<T, W>::isVisited() {
     return visited;
 }
 
 // Set the visited status of the vertex
 // Parameters: - v: The visited status to be assigned to the vertex.
 // Return value: None.
-template <typename T>
-void Vertex<T>::setVisited(bool v) {
+template <typename T, typename W>
+void Vertex<T, W>::setVisited(bool v) {
     visited = v;
 }
 
 // Get the distance from the source vertex
 // Parameters: None.
 // Return value: The distance from the source vertex.
-template <typename T>
-double Vertex<T>::getDistance() {
+template <typename T, typename W>
+double Vertex<T, W>::getDistance() {
     return distance;
 }
 
 // Set the distance from the source vertex
 // Parameters: - d: The distance to be assigned to the vertex.
 // Return value: None.
-template <typename T>
-void Vertex<T>::setDistance(double d) {
+template <typename T, typename W>
+void Vertex<T, W>::setDistance(double d) {
     distance = d;
 }
 
 // Get the finish time of the vertex
 // Parameters: None.
 // Return value: The finish time of the vertex.
-template <typename T>
-int Vertex<T>::getFinishTime() {
+template <typename T, typename W>
+int Vertex<T, W>::getFinishTime() {
     return finishTime;
 }
 
 // Set the finish time of the vertex
 // Parameters: - time: The finish time to be assigned to the vertex.
 // Return value: None.
-template <typename T>
-void Vertex<T>::setFinishTime(int time) {
+template <typename T, typename W>
+void Vertex<T, W>::setFinishTime(int time) {
     finishTime = time;
 }
 
@@ -142,8 +147,8 @@ void Vertex<T>::setFinishTime(int time) {
 // Parameters: None.
 // Return value: A pointer to the parent vertex.
 // If the parent is null, it indicates that the vertex has no parent.
-template <typename T>
-Vertex<T>* Vertex<T>::getParent() {
+template <typename T, typename W>
+Vertex<T, W>* Vertex<T, W>::getParent() {
     if (parent == nullptr) {
         return nullptr;
     }
@@ -153,22 +158,73 @@ Vertex<T>* Vertex<T>::getParent() {
 // Set the parent vertex
 // Parameters: - p: A pointer to the parent vertex to be assigned.
 // Return value: None.
-template <typename T>
-void Vertex<T>::setParent(Vertex<T>* p) {
+template <typename T, typename W>
+void Vertex<T, W>::setParent(Vertex<T, W>* p) {
     parent = p;
 }
 
+// Get the index of the vertex
+// Parameters: None.
+// Return value: The position of the vertex in the vertex list of the graph that owns it.
+// The index is maintained by DirectedGraph and is used to address per-vertex arrays.
+template <typename T, typename W>
+size_t Vertex<T, W>::getIndex() {
+    return index;
+}
+
+// Set the index of the vertex
+// Parameters: - i: The index to be assigned to the vertex.
+// Return value: None.
+template <typename T, typename W>
+void Vertex<T, W>::setIndex(size_t i) {
+    index = i;
+}
+
+// Get the memory the edges of the vertex are allocated from
+// Parameters: None.
+// Return value: The memory resource given to the constructor.
+template <typename T, typename W>
+pmr::memory_resource* Vertex<T, W>::getMemory() {
+    return adjacencyList.get_allocator().resource();
+}
+
+// Make room for edges
+// Parameters: - outgoing: The number of edges from this vertex to make room for.
+// - incomingEdges: The number of edges into this vertex to make room for.
+// Return value: None.
+template <typename T, typename W>
+void Vertex<T, W>::reserveEdges(size_t outgoing, size_t incomingEdges) {
+    adjacencyList.reserve(outgoing);
+    incoming.reserve(incomingEdges);
+}
+
 // Add an edge from this vertex to another vertex
 // (i.e., add the other vertex to this vertex's adjacency list)
 // Parameters: - v: A pointer to the vertex to be added.
-// - w: The weight of the edge (default is 1.0).
+// - w: The weight of the edge (default is 1).
 // - name: The name of the edge (default is an empty string).
 // Return value: None.
 // The adjacency list is a vector of tuples, where each tuple contains the inbound vertex,
-// the weight of the edge, and the name of the edge.
-template <typename T>
-void Vertex<T>::addEdge(Vertex<T>* v, double w, string name) {
-    adjacencyList.push_back(tuple<Vertex<T>*, double, string>(v, w, name));
+// the weight of the edge, and the ID of the name of the edge, which is interned in NameTable::global().
+// The edge is also recorded in the edge index of this vertex (once built) and the reverse adjacency of v.
+template <typename T, typename W>
+void Vertex<T, W>::addEdge(Vertex<T, W>* v, W w, string_view name) {
+    addInternedEdge(v, w, NameTable::global().intern(name));
+}
+
+// Add an edge with an interned name from this vertex to another vertex
+// Parameters: - v: A pointer to the vertex to be added.
+// - w: The weight of the edge.
+// - nameId: The ID of the name of the edge in NameTable::global().
+// Return value: None.
+// Copying edges this way skips looking their names up again.
+template <typename T, typename W>
+void Vertex<T, W>::addInternedEdge(Vertex<T, W>* v, W w, uint32_t nameId) {
+    if (!edgeIndex.empty()) {
+        edgeIndex.emplace(v, adjacencyList.size()); // keeps the position of an earlier edge to v
+    }
+    adjacencyList.emplace_back(v, w, nameId);
+    v->incoming.push_back(this);
 }
 
 // Remove an edge from this vertex to another vertex
@@ -176,26 +232,131 @@ void Vertex<T>::addEdge(Vertex<T>* v, double w, string name) {
 // Parameters: - v: A pointer to the vertex to be removed.
 // Return value: None.
 // If the edge does not exist, an exception is thrown.
-template <typename T>
-void Vertex<T>::removeEdge(Vertex<T>* v) {
+// Note: The edge is found through the edge index; only the edges after it are visited, to shift their positions.
+// If there are several edges to v, the first one is removed.
+template <typename T, typename W>
+void Vertex<T, W>::removeEdge(Vertex<T, W>* v) {
+    indexEdges();
     // Throw an exception if edge does not exist
-    if (adjacencyList.empty()) {
+    auto found = edgeIndex.find(v);
+    if (found == edgeIndex.end()) {
         throw runtime_error("Edge does not exist");
     }
-    typename vector<tuple <Vertex<T>*, double, string>>::iterator it = adjacencyList.begin();
-    while (it != adjacencyList.end()) {
-        if (get<0>(*it) == v) {
-            adjacencyList.erase(it);
+    size_t pos = found->second;
+    adjacencyList.erase(adjacencyList.begin() + pos);
+    edgeIndex.erase(found);
+    // the edges after the removed one move up by one; a later edge to v becomes the first
+    for (size_t i = pos; i < adjacencyList.size(); ++i) {
+        Vertex<T, W>* head = get<0>(adjacencyList[i]);
+        if (head == v) {
+            edgeIndex.emplace(v, i);
+        } else if (edgeIndex[head] == i + 1) {
+            edgeIndex[head] = i;
+        }
+    }
+    // drop one entry for this vertex from the reverse adjacency of v
+    for (size_t i = 0; i < v->incoming.size(); ++i) {
+        if (v->incoming[i] == this) {
+            v->incoming[i] = v->incoming.back();
+            v->incoming.pop_back();
             break;
         }
-        ++it;
     }
 }
 
+// Build the edge index
+// Parameters: None.
+// Return value: None.
+// An empty index with a non-empty adjacency list means the index was not built yet; once built, addEdge and
+// removeEdge keep it up to date.
+template <typename T, typename W>
+void Vertex<T, W>::indexEdges() {
+    if (!edgeIndex.empty()) return;
+    edgeIndex.reserve(adjacencyList.size());
+    for (size_t i = 0; i < adjacencyList.size(); ++i) {
+        edgeIndex.emplace(get<0>(adjacencyList[i]), i);
+    }
+}
+
+// Check whether this vertex has an edge to another vertex
+// Parameters: - v: A pointer to the other vertex.
+// Return value: true if there is an edge from this vertex to v, false otherwise.
+template <typename T, typename W>
+bool Vertex<T, W>::hasEdge(Vertex<T, W>* v) {
+    indexEdges();
+    return edgeIndex.find(v) != edgeIndex.end();
+}
+
+// Set the weight of the edge from this vertex to another vertex
+// Parameters: - v: A pointer to the head of the edge.
+// - w: The new weight of the edge.
+// Return value: The position of the edge in the adjacency list.
+// The edge is found through the edge index in O(1); if there are several edges to v, the first one is changed.
+// If the edge does not exist, an exception is thrown.
+template <typename T, typename W>
+size_t Vertex<T, W>::setEdgeWeight(Vertex<T, W>* v, W w) {
+    indexEdges();
+    auto found = edgeIndex.find(v);
+    if (found == edgeIndex.end()) {
+        throw runtime_error("Edge does not exist");
+    }
+    get<1>(adjacencyList[found->second]) = w;
+    return found->second;
+}
+
+// Get the name of an edge
+// Parameters: - e: An edge of an adjacency list.
+// Return value: A reference to the name of the edge, valid for the life of the process.
+template <typename T, typename W>
+const string& Vertex<T, W>::edgeName(const Edge& e) {
+    return NameTable::global().name(get<2>(e));
+}
+
+// Convert a weight to the weight type
+// Parameters: - w: The weight as a double.
+// Return value: w as a W, in units of WeightTraits<W>::scale.
+// It throws std::out_of_range if w does not fit W.
+template <typename T, typename W>
+W Vertex<T, W>::toWeight(double w) {
+    return WeightTraits<W>::toWeight(w);
+}
+
+// Convert a real weight to a stored weight
+// Parameters: - w: The real weight.
+// Return value: w divided by scale, rounded to the nearest integer if W is integral.
+// It throws std::out_of_range if the result does not fit W; infinity and NaN fit only floating-point types.
+template <typename W>
+W WeightTraits<W>::toWeight(double w) {
+    double units = w * scale::den / scale::num;
+    if (!is_integral<W>::value) return static_cast<W>(units);
+    units = round(units);
+    // the upper bound is exclusive, since the largest values of 64-bit types round up when converted to double
+    if (!(units >= static_cast<double>(numeric_limits<W>::min()) && units < static_cast<double>(numeric_limits<W>::max()) + 1.0)) {
+        throw out_of_range("Edge weight " + to_string(w) + " does not fit the weight type");
+    }
+    return static_cast<W>(units);
+}
+
+// Convert a stored weight to a real weight
+// Parameters: - w: The stored weight.
+// Return value: w times scale.
+template <typename W>
+double WeightTraits<W>::toDouble(W w) {
+    return static_cast<double>(w) * scale::num / scale::den;
+}
+
 // Get the adjacency list of the vertex
 // Parameters: None.
 // Return value: A reference to the adjacency list of the vertex.
-template <typename T>
-vector<tuple <Vertex<T>*, double, string>>& Vertex<T>::getAdjacencyList() {
+template <typename T, typename W>
+pmr::vector<typename Vertex<T, W>::Edge>& Vertex<T, W>::getAdjacencyList() {
     return adjacencyList;
+}
+
+// Get the reverse adjacency of the vertex
+// Parameters: None.
+// Return value: A reference to the tails of the edges into this vertex, one entry per edge, in no particular order.
+template <typename T, typename W>
+const pmr::vector<Vertex<T, W>*>& Vertex<T, W>::getIncoming() {
+    return incoming;
 }
\ No newline at end of file
@@ -0,0 +1,526 @@
+/*
+benchmarks.cpp
+This file contains the benchmark suite for the hot paths of the route planner:
+- load: parsing and building graphs from denison.out and from generated grid and random geometric graphs
+  of 10^4 up to 10^7 vertices (text file, CSR snapshot, binary image), copying and destroying them, and the
+  memory a loaded graph holds
+- pq: insert, updateKey and pop throughput of minPQ and of the indexed queue used by the searches
+- query: single-source (Dijkstra, and delta-stepping on 1, 2, 4, ... threads up to the hardware threads),
+  point-to-point and random-pair query latency at p50, p95 and p99
+- matrix: the distance matrix API against running Dijkstra once per source
+Every workload is generated from fixed seeds, so runs on the same machine can be compared over time.
+Build: g++ -std=c++17 -O2 -pthread benchmarks.cpp -o benchmarks
+Usage: benchmarks [--json] [--only=load|pq|query|matrix] [--max-vertices=N] [--queries=N] [graph file]
+  --json            print one JSON object per result instead of a table, for scripts that compare runs
+  --max-vertices=N  largest generated graph (default 1000000, at most 10000000)
+  --queries=N       queries per latency case (default 1000; fewer on graphs over 10^5 vertices, so a run stays short)
+Contraction hierarchies are only built for graphs of at most 50000 vertices, as preprocessing bigger ones takes minutes.
+  graph file        the real graph to load and query (default denison.out)
+Written by: Khoi V.
+*/
+#include <cassert>
+#include <iostream>
+#include <iomanip> // for std::setw
+#include <fstream>
+#include <cmath>   // for fabs
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm> // for std::sort, std::unique
+#include <thread> // for std::thread::hardware_concurrency
+#include <cstdio> // for std::remove
+#include <memory> // for std::unique_ptr
+#include <sys/resource.h> // for getrusage
+#ifdef __GLIBC__
+#include <malloc.h> // for mallinfo2
+#endif
+#include "DirectedGraph.hpp"
+#include "Vertex.hpp"
+#include "MinPriorityQueue.hpp"
+#include "IndexedMinPriorityQueue.hpp"
+#include "GraphFile.hpp"
+#include "GraphImage.hpp"
+#include "GreatCircleHeuristic.hpp"
+#include "ContractionHierarchy.hpp"
+#include "SpatialIndex.hpp"
+
+using namespace std;
+
+// Milliseconds elapsed since start
+static double elapsedMs(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+// Memory in use in megabytes: the heap blocks allocated with glibc, elsewhere the resident memory of the process
+// from /proc/self/statm (which does not drop when freed memory is kept for reuse, so it is 0 where not available)
+static double memoryInUseMB() {
+#ifdef __GLIBC__
+    struct mallinfo2 info = mallinfo2();
+    return (info.uordblks + info.hblkhd) / static_cast<double>(1 << 20);
+#else
+    ifstream statm("/proc/self/statm");
+    double pages = 0, resident = 0;
+    statm >> pages >> resident;
+    return resident * 4096.0 / (1 << 20);
+#endif
+}
+
+// Peak resident memory of the process so far, in megabytes
+static double peakResidentMB() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.0;
+}
+
+// Collects the results and prints each one as it comes, as a table row or a JSON object
+class Reporter {
+public:
+    bool json = false;
+    bool quiet = false; // drop the results instead of printing them
+
+    // Prints one result: group and case name the measurement, metric says what was measured
+    void add(const string& group, const string& name, const string& metric, double value, const string& unit) {
+        if (quiet) return;
+        if (json) {
+            cout << "{\"group\":\"" << group << "\",\"case\":\"" << name << "\",\"metric\":\"" << metric
+                 << "\",\"value\":" << value << ",\"unit\":\"" << unit << "\"}" << endl;
+        } else {
+            cout << left << setw(8) << group << setw(22) << name << setw(30) << metric
+                 << right << setw(14) << fixed << setprecision(3) << value << " " << unit << endl;
+            cout.unsetf(ios::fixed);
+        }
+    }
+
+    // Prints the p50, p95 and p99 of the latencies (in microseconds)
+    void percentiles(const string& group, const string& name, const string& metric, vector<double> us) {
+        if (us.empty()) return;
+        sort(us.begin(), us.end());
+        // nearest-rank percentile
+        auto rank = [&](double p) { return us[min(us.size() - 1, static_cast<size_t>(ceil(p * us.size())) - 1)]; };
+        add(group, name, metric + " p50", rank(0.50), "us");
+        add(group, name, metric + " p95", rank(0.95), "us");
+        add(group, name, metric + " p99", rank(0.99), "us");
+    }
+};
+
+// A graph to benchmark: its file, the loaded graph and the coordinates of its vertices by index
+struct Workload {
+    string name;
+    string file;
+    bool generated; // the file is generated before loading and removed after
+    bool grid; // kind of generated graph: grid or random geometric
+    size_t vertices; // size of generated graph
+    unique_ptr<DirectedGraph<size_t>> graph;
+    vector<pair<double,double>> coords;
+};
+
+// Function to write a generated graph in the text graph format
+// Parameters: file - the file to write, coords - the vertex coordinates (the vertex ids are 0..n-1),
+// edges - (from, to, weight) triples; names - the name of each edge.
+// Return value: None.
+static void writeGraph(const string& file, const vector<pair<double,double>>& coords,
+                       const vector<tuple<size_t, size_t, double>>& edges, const vector<string>& names) {
+    ofstream out(file);
+    out << setprecision(10);
+    out << coords.size() << " " << edges.size() << "\n";
+    for (size_t i = 0; i < coords.size(); ++i) {
+        out << i << " " << coords[i].first << " " << coords[i].second << "\n";
+    }
+    for (size_t k = 0; k < edges.size(); ++k) {
+        out << get<0>(edges[k]) << " " << get<1>(edges[k]) << " " << get<2>(edges[k]) << " " << names[k] << "\n";
+    }
+}
+
+// Largest graph the contraction hierarchy is built for
+static const size_t CH_MAX_VERTICES = 50000;
+
+// Length in metres of a degree of latitude, for edge weights of the generated graphs
+static const double METRES_PER_DEGREE = 111195.0;
+
+// Function to generate a square grid road map
+// Description: side x side vertices about 100 m apart near (-82.5, 40.0), joined to their four neighbours by
+// two-way streets whose weights are the length times a random slowdown of 1 to 2.
+// Parameters: n - the number of vertices wanted (rounded down to a square), file - the file to write.
+// Return value: None.
+static void generateGrid(size_t n, const string& file) {
+    size_t side = static_cast<size_t>(sqrt(static_cast<double>(n)));
+    const double step = 0.0009;
+    mt19937 rng(1);
+    uniform_real_distribution<double> slow(1.0, 2.0);
+    vector<pair<double,double>> coords;
+    coords.reserve(side * side);
+    for (size_t r = 0; r < side; ++r) {
+        for (size_t c = 0; c < side; ++c) coords.push_back({-82.5 + c * step, 40.0 + r * step});
+    }
+    vector<tuple<size_t, size_t, double>> edges;
+    vector<string> names;
+    double dx = step * cos(40.0 * M_PI / 180.0) * METRES_PER_DEGREE, dy = step * METRES_PER_DEGREE;
+    for (size_t r = 0; r < side; ++r) {
+        for (size_t c = 0; c < side; ++c) {
+            size_t i = r * side + c;
+            if (c + 1 < side) {
+                edges.push_back({i, i + 1, dx * slow(rng)});
+                edges.push_back({i + 1, i, dx * slow(rng)});
+                names.push_back("Row " + to_string(r) + " Street");
+                names.push_back("Row " + to_string(r) + " Street");
+            }
+            if (r + 1 < side) {
+                edges.push_back({i, i + side, dy * slow(rng)});
+                edges.push_back({i + side, i, dy * slow(rng)});
+                names.push_back("Column " + to_string(c) + " Avenue");
+                names.push_back("Column " + to_string(c) + " Avenue");
+            }
+        }
+    }
+    writeGraph(file, coords, edges, names);
+}
+
+// Function to generate a random geometric road map
+// Description: n vertices spread uniformly over a square of the same density as the grid; every vertex is joined to
+// its four nearest vertices by two-way roads whose weights are the length times a random slowdown of 1 to 1.5.
+// Parameters: n - the number of vertices, file - the file to write.
+// Return value: None.
+static void generateGeometric(size_t n, const string& file) {
+    double span = sqrt(static_cast<double>(n)) * 0.0009;
+    mt19937 rng(2);
+    uniform_real_distribution<double> at(0.0, span), slow(1.0, 1.5);
+    vector<pair<double,double>> coords(n);
+    for (auto &p : coords) {
+        p.first = -82.5 + at(rng);
+        p.second = 40.0 + at(rng);
+    }
+    double xScale = SpatialIndex::lonScale(coords.data(), n);
+    SpatialIndex index(coords.data(), n, xScale);
+    vector<pair<size_t, size_t>> roads;
+    roads.reserve(4 * n);
+    for (size_t i = 0; i < n; ++i) {
+        for (auto &m : index.nearest(coords[i].first, coords[i].second, 5)) {
+            if (m.id != i) roads.push_back({min(i, m.id), max(i, m.id)});
+        }
+    }
+    sort(roads.begin(), roads.end());
+    roads.erase(unique(roads.begin(), roads.end()), roads.end());
+    vector<tuple<size_t, size_t, double>> edges;
+    vector<string> names;
+    edges.reserve(2 * roads.size());
+    names.reserve(2 * roads.size());
+    for (auto &[a, b] : roads) {
+        double dx = (coords[a].first - coords[b].first) * xScale, dy = coords[a].second - coords[b].second;
+        double metres = sqrt(dx * dx + dy * dy) * METRES_PER_DEGREE;
+        string name = "Road " + to_string(a % 1000);
+        edges.push_back({a, b, metres * slow(rng)});
+        edges.push_back({b, a, metres * slow(rng)});
+        names.push_back(name);
+        names.push_back(name);
+    }
+    writeGraph(file, coords, edges, names);
+}
+
+// Function to time loading a graph
+// Description: Times the text parser alone, DirectedGraph::readFromFile, copying and destroying the graph, the CSR
+// snapshot and opening the graph written as a binary image, and measures the memory the graph holds and the peak
+// memory of the process so far; the loaded graph and its coordinates are kept in w for the query benchmarks.
+// Parameters: w - the workload, whose file is read, report - receives the results.
+// Return value: None.
+static void benchLoad(Workload& w, Reporter& report) {
+    auto start = chrono::steady_clock::now();
+    {
+        GraphFile parsed(w.file);
+        report.add("load", w.name, "parse", elapsedMs(start), "ms");
+        w.coords = move(parsed.coords);
+    }
+    double before = memoryInUseMB();
+    start = chrono::steady_clock::now();
+    w.graph.reset(new DirectedGraph<size_t>(DirectedGraph<size_t>().readFromFile(w.file)));
+    report.add("load", w.name, "readFromFile", elapsedMs(start), "ms");
+    report.add("load", w.name, "graph memory", memoryInUseMB() - before, "MB");
+    report.add("load", w.name, "peak memory", peakResidentMB(), "MB");
+    start = chrono::steady_clock::now();
+    {
+        DirectedGraph<size_t> copy(*w.graph);
+        report.add("load", w.name, "copy", elapsedMs(start), "ms");
+        start = chrono::steady_clock::now();
+    }
+    report.add("load", w.name, "destroy", elapsedMs(start), "ms");
+    start = chrono::steady_clock::now();
+    const CSRGraph<size_t>& net = w.graph->snapshot();
+    report.add("load", w.name, "snapshot", elapsedMs(start), "ms");
+    report.add("load", w.name, "vertices", net.numVertices(), "count");
+    report.add("load", w.name, "edges", net.numEdges(), "count");
+
+    string image = w.file + ".bin";
+    GraphImage<size_t>::write(image, net, w.coords);
+    start = chrono::steady_clock::now();
+    {
+        GraphImage<size_t> mapped(image);
+        assert(mapped.graph().numEdges() == net.numEdges());
+        report.add("load", w.name, "image open", elapsedMs(start), "ms");
+    }
+    remove(image.c_str());
+}
+
+// Function to time the priority queues
+// Description: Inserts n random keys, lowers the keys of n/2 random entries, then pops everything, timing each phase
+// for minPQ and for the 4-ary indexed queue the searches use.
+// Parameters: n - the number of entries, report - receives the results in millions of operations per second.
+// Return value: None.
+static void benchQueues(size_t n, Reporter& report) {
+    mt19937 rng(3);
+    uniform_real_distribution<double> key(0.0, 1e6);
+    uniform_int_distribution<size_t> pick(0, n - 1);
+    vector<double> keys(n);
+    for (auto &k : keys) k = key(rng);
+    vector<size_t> lowered(n / 2);
+    for (auto &i : lowered) i = pick(rng);
+    string name = "n=" + to_string(n);
+    auto mops = [](size_t ops, double ms) { return ops / ms / 1000.0; };
+
+    {
+        minPQ<double, size_t> pq(n);
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < n; ++i) pq.insert(keys[i], i);
+        report.add("pq", name, "minPQ insert", mops(n, elapsedMs(start)), "Mops/s");
+        start = chrono::steady_clock::now();
+        for (size_t i : lowered) {
+            keys[i] *= 0.5;
+            pq.updateKey(keys[i], i);
+        }
+        report.add("pq", name, "minPQ updateKey", mops(lowered.size(), elapsedMs(start)), "Mops/s");
+        start = chrono::steady_clock::now();
+        double last = -1.0;
+        while (!pq.empty()) {
+            double k = pq.pop().first;
+            assert(k >= last);
+            last = k;
+        }
+        report.add("pq", name, "minPQ pop", mops(n, elapsedMs(start)), "Mops/s");
+    }
+    for (auto &k : keys) k = key(rng);
+    {
+        indexedMinPQ<double> pq(n);
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < n; ++i) pq.insert(keys[i], i);
+        report.add("pq", name, "indexed insert", mops(n, elapsedMs(start)), "Mops/s");
+        start = chrono::steady_clock::now();
+        for (size_t i : lowered) {
+            keys[i] *= 0.5;
+            pq.updateKey(keys[i], i);
+        }
+        report.add("pq", name, "indexed updateKey", mops(lowered.size(), elapsedMs(start)), "Mops/s");
+        start = chrono::steady_clock::now();
+        double last = -1.0;
+        while (!pq.empty()) {
+            double k = pq.pop().first;
+            assert(k >= last);
+            last = k;
+        }
+        report.add("pq", name, "indexed pop", mops(n, elapsedMs(start)), "Mops/s");
+    }
+}
+
+// Function to time queries on a loaded workload
+// Description: Single-source: full Dijkstra from random sources, then delta-stepping from the same sources on 1, 2, 4,
+// ... threads (as many as the hardware has), checked against Dijkstra. Point-to-point: every search algorithm between the
+// same random pairs (Dijkstra, bidirectional, A*, contraction hierarchy), checked against each other.
+// Random-pair: DirectedGraph::shortestPath between random vertices, the whole public path including the conversion
+// back to vertices. Each query reuses one search context.
+// Parameters: w - the loaded workload, queries - the number of queries per case, report - receives the results.
+// Return value: None.
+static void benchQueries(Workload& w, size_t queries, Reporter& report) {
+    const CSRGraph<size_t>& net = w.graph->snapshot();
+    size_t n = net.numVertices();
+    if (n == 0) return;
+    // a point-to-point query settles O(n) vertices, so fewer of them on big graphs
+    queries = min(queries, max<size_t>(20, 100000000 / n));
+    mt19937 rng(4);
+    uniform_int_distribution<size_t> pick(0, n - 1);
+    vector<pair<size_t, size_t>> pairs(queries);
+    for (auto &p : pairs) p = {pick(rng), pick(rng)};
+    SearchContext ctx;
+    vector<double> us;
+    vector<size_t> path;
+
+    // full searches cost O(n log n) each, so fewer of them on big graphs
+    size_t full = max<size_t>(5, min(queries, 2000000 / n));
+    for (size_t q = 0; q < full; ++q) {
+        auto start = chrono::steady_clock::now();
+        net.Dijkstra(ctx, pairs[q].first);
+        us.push_back(elapsedMs(start) * 1000.0);
+    }
+    report.percentiles("query", w.name, "single-source", us);
+
+    size_t hardware = max<size_t>(1, thread::hardware_concurrency());
+    vector<double> dist, reference;
+    vector<size_t> parent;
+    for (size_t threads = 1; threads <= hardware; threads *= 2) {
+        DeltaStepping<size_t> search(net, threads);
+        us.clear();
+        for (size_t q = 0; q < full; ++q) {
+            auto start = chrono::steady_clock::now();
+            search.run(pairs[q].first, dist, parent);
+            us.push_back(elapsedMs(start) * 1000.0);
+            if (q + 1 == full) {
+                net.Dijkstra(ctx, pairs[q].first);
+                reference.resize(n);
+                for (size_t v = 0; v < n; ++v) reference[v] = ctx.forward.getDistance(v);
+                assert(dist == reference);
+            }
+        }
+        report.percentiles("query", w.name, "single-source delta " + to_string(threads) + "T", us);
+    }
+
+    vector<double> expected(queries);
+    us.clear();
+    for (size_t q = 0; q < queries; ++q) {
+        auto start = chrono::steady_clock::now();
+        expected[q] = net.shortestPath(ctx, pairs[q].first, pairs[q].second, path);
+        us.push_back(elapsedMs(start) * 1000.0);
+    }
+    report.percentiles("query", w.name, "p2p dijkstra", us);
+
+    auto check = [&](size_t q, double d) {
+        assert(d == expected[q] || fabs(d - expected[q]) < 1e-6 * expected[q]);
+    };
+    us.clear();
+    for (size_t q = 0; q < queries; ++q) {
+        auto start = chrono::steady_clock::now();
+        double d = net.bidirectionalDijkstra(ctx, pairs[q].first, pairs[q].second, path);
+        us.push_back(elapsedMs(start) * 1000.0);
+        check(q, d);
+    }
+    report.percentiles("query", w.name, "p2p bidirectional", us);
+
+    double costPerMetre = GreatCircleHeuristic::minCostPerMetre(net, w.coords);
+    us.clear();
+    for (size_t q = 0; q < queries; ++q) {
+        auto start = chrono::steady_clock::now();
+        GreatCircleHeuristic h(w.coords, costPerMetre, pairs[q].second);
+        double d = net.aStar(ctx, pairs[q].first, pairs[q].second, h, path);
+        us.push_back(elapsedMs(start) * 1000.0);
+        check(q, d);
+    }
+    report.percentiles("query", w.name, "p2p astar", us);
+
+    auto start = chrono::steady_clock::now();
+    if (n <= CH_MAX_VERTICES) {
+        ContractionHierarchy<size_t> ch(net);
+        report.add("query", w.name, "ch build", elapsedMs(start), "ms");
+        us.clear();
+        for (size_t q = 0; q < queries; ++q) {
+            start = chrono::steady_clock::now();
+            double d = ch.query(ctx, pairs[q].first, pairs[q].second, path);
+            us.push_back(elapsedMs(start) * 1000.0);
+            check(q, d);
+        }
+        report.percentiles("query", w.name, "p2p ch", us);
+    }
+
+    vector<Vertex<size_t>*> verts = w.graph->getVertices();
+    us.clear();
+    for (size_t q = 0; q < queries; ++q) {
+        Vertex<size_t>* u = verts[pick(rng)];
+        Vertex<size_t>* v = verts[pick(rng)];
+        start = chrono::steady_clock::now();
+        w.graph->shortestPath(u, v);
+        us.push_back(elapsedMs(start) * 1000.0);
+    }
+    report.percentiles("query", w.name, "random-pair", us);
+}
+
+// Function to time the distance matrix API
+// Description: Compares one full Dijkstra per source (through the returned list and through a reused search context)
+// with distanceMatrix on 1, 2, 4 and 8 threads, checking that all of them agree.
+// Parameters: w - the loaded workload, report - receives the results.
+// Return value: None.
+static void benchMatrix(Workload& w, Reporter& report) {
+    DirectedGraph<size_t>& g = *w.graph;
+    vector<Vertex<size_t>*> verts = g.getVertices();
+    if (verts.empty()) return;
+
+    // 100 random sources and 100 random targets, the same every run
+    const size_t N = 100, M = 100;
+    mt19937 rng(42);
+    uniform_int_distribution<size_t> pick(0, verts.size() - 1);
+    vector<Vertex<size_t>*> sources, targets;
+    for (size_t i = 0; i < N; ++i) sources.push_back(verts[pick(rng)]);
+    for (size_t j = 0; j < M; ++j) targets.push_back(verts[pick(rng)]);
+    string name = w.name + " 100x100";
+
+    // 1) one full Dijkstra per source, distances pulled out of the returned list by position
+    auto start = chrono::steady_clock::now();
+    vector<double> expected(N * M);
+    for (size_t i = 0; i < N; ++i) {
+        auto list = g.Dijkstra(sources[i]);
+        for (size_t j = 0; j < M; ++j) expected[i * M + j] = list[targets[j]->getIndex()].second;
+    }
+    report.add("matrix", name, "Dijkstra (list)", elapsedMs(start), "ms");
+
+    // 2) one full Dijkstra per source, reusing a search context
+    start = chrono::steady_clock::now();
+    SearchContext ctx;
+    for (size_t i = 0; i < N; ++i) {
+        g.Dijkstra(sources[i], ctx);
+        for (size_t j = 0; j < M; ++j) assert(ctx.forward.getDistance(targets[j]->getIndex()) == expected[i * M + j]);
+    }
+    report.add("matrix", name, "Dijkstra (context)", elapsedMs(start), "ms");
+
+    // 3) the matrix API, stopping each search once the targets are settled
+    for (size_t threads : {1, 2, 4, 8}) {
+        start = chrono::steady_clock::now();
+        vector<Vertex<size_t>*> preds;
+        vector<double> dist = g.distanceMatrix(sources, targets, &preds, threads);
+        double ms = elapsedMs(start);
+        for (size_t k = 0; k < N * M; ++k) {
+            assert(dist[k] == expected[k] || fabs(dist[k] - expected[k]) < 1e-9);
+        }
+        report.add("matrix", name, "distanceMatrix " + to_string(threads) + "T", ms, "ms");
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Reporter report;
+    string only, fname = "denison.out";
+    size_t maxVertices = 1000000, queries = 1000;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--json") report.json = true;
+        else if (arg.rfind("--only=", 0) == 0) only = arg.substr(7);
+        else if (arg.rfind("--max-vertices=", 0) == 0) maxVertices = min<size_t>(stoul(arg.substr(15)), 10000000);
+        else if (arg.rfind("--queries=", 0) == 0) queries = max<size_t>(1, stoul(arg.substr(10)));
+        else if (arg[0] != '-') fname = arg;
+        else {
+            cerr << "Usage: " << argv[0] << " [--json] [--only=load|pq|query|matrix] [--max-vertices=N] [--queries=N] [graph file]" << endl;
+            return 1;
+        }
+    }
+    auto runs = [&](const string& group) { return only.empty() || only == group; };
+    report.add("meta", "machine", "hardware threads", thread::hardware_concurrency(), "count");
+
+    if (runs("pq")) {
+        for (size_t n = 10000; n <= min<size_t>(maxVertices, 1000000); n *= 10) benchQueues(n, report);
+    }
+    if (!runs("load") && !runs("query") && !runs("matrix")) return 0;
+
+    // The real graph, then generated graphs of 10^4, 10^5, ... vertices
+    vector<Workload> workloads;
+    workloads.push_back(Workload{fname, fname, false, false, 0, nullptr, {}});
+    for (size_t n = 10000; n <= maxVertices; n *= 10) {
+        string size = "1e" + to_string(static_cast<int>(round(log10(static_cast<double>(n)))));
+        workloads.push_back(Workload{"grid-" + size, "bench_grid_" + size + ".txt", true, true, n, nullptr, {}});
+        workloads.push_back(Workload{"geometric-" + size, "bench_geometric_" + size + ".txt", true, false, n, nullptr, {}});
+    }
+    for (auto &w : workloads) {
+        if (w.generated && w.grid) generateGrid(w.vertices, w.file);
+        if (w.generated && !w.grid) generateGeometric(w.vertices, w.file);
+        // the graph is loaded either way; only the load timings are skipped
+        Reporter quiet;
+        quiet.quiet = true;
+        benchLoad(w, runs("load") ? report : quiet);
+        if (w.generated) remove(w.file.c_str());
+        if (runs("query")) benchQueries(w, queries, report);
+        if (runs("matrix") && !w.generated) benchMatrix(w, report);
+        w.graph.reset(); // free the graph before the next, bigger one
+    }
+    return 0;
+}
@@ -4,15 +4,112 @@ This file contains the main function for the CLI route planner program.
 Written by: Khoi V.
 */
 #include <iostream>
+#include <string>
+#include <fstream>
+#include <charconv> // for std::from_chars
+#include <limits> // for std::numeric_limits
 #include "CLI.hpp"
 
 using namespace std;
 
-int main() {
+// Function to read the number of a flag such as --threads=N
+// Parameters: arg - the argument, prefix - the flag up to and including '=', most - the largest value allowed,
+// out - receives the value.
+// Return value: true if arg is prefix followed by digits only and the value is at most most, false otherwise.
+static bool flagValue(const string& arg, const string& prefix, size_t most, size_t& out) {
+    if (arg.compare(0, prefix.size(), prefix) != 0 || arg.size() == prefix.size()) return false;
+    const char* end = arg.data() + arg.size();
+    size_t value;
+    auto [p, ec] = from_chars(arg.data() + prefix.size(), end, value);
+    if (ec != errc() || p != end || value > most) return false;
+    out = value;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    // Select the search algorithm: --search=dijkstra, --search=bidirectional (default), --search=astar
+    // or --search=ch (contraction hierarchies, preprocessed when the graph is loaded)
+    // --convert <graph file> <image file> writes the graph as a binary image and exits
+    // --batch <graph file> [query file] answers the query lines of the file (or stdin) without prompting,
+    // with --directions to add turn-by-turn directions and --threads=N to set the number of search threads
+    // --tree-cache=MB answers routes from cached shortest-path trees of the start points, using at most MB megabytes
+    // --stats prints the counters of every query and, on exit, the latency histograms (to stderr in batch mode);
+    // --stats-dump=FILE writes the histograms to FILE as JSON on exit (both need a build with -DROUTE_STATS)
+    // --alternatives=K prints up to K alternative routes, with their directions, after each shortest route
+    GraphMap gm;
+    string batchGraph, batchQueries, statsFile;
+    bool batch = false, withDirections = false, showStats = false;
+    size_t threads = 0, value;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--search=dijkstra") gm.set_mode(SearchMode::DIJKSTRA);
+        else if (arg == "--search=bidirectional") gm.set_mode(SearchMode::BIDIRECTIONAL);
+        else if (arg == "--search=astar") gm.set_mode(SearchMode::ASTAR);
+        else if (arg == "--search=ch") gm.set_mode(SearchMode::CH);
+        else if (arg == "--convert" && argc == 4 && i == 1) {
+            if (!gm.load(argv[2])) return 1;
+            try {
+                gm.save(argv[3]);
+            } catch (const runtime_error& e) {
+                cerr << e.what() << endl;
+                return 1;
+            }
+            cout << "Wrote " << argv[3] << endl;
+            return 0;
+        }
+        else if (arg == "--batch" && i + 1 < argc) {
+            batch = true;
+            batchGraph = argv[++i];
+            if (i + 1 < argc && argv[i + 1][0] != '-') batchQueries = argv[++i];
+        }
+        else if (arg == "--directions") withDirections = true;
+        else if (flagValue(arg, "--threads=", numeric_limits<size_t>::max(), value)) threads = value;
+        // the budget is given in megabytes, so it must still fit once shifted to bytes
+        else if (flagValue(arg, "--tree-cache=", numeric_limits<size_t>::max() >> 20, value)) gm.set_tree_cache(value << 20);
+        else if (flagValue(arg, "--alternatives=", numeric_limits<size_t>::max() - 1, value)) {
+            AlternativeLimits limits;
+            limits.count = value + 1;
+            gm.set_alternatives(limits);
+        }
+        else if (arg == "--stats") showStats = true;
+        else if (arg.rfind("--stats-dump=", 0) == 0 && arg.size() > 13) statsFile = arg.substr(13);
+        else {
+            cerr << "Usage: " << argv[0] << " [--search=dijkstra|bidirectional|astar|ch] [--tree-cache=MB] [--alternatives=K] [--stats] [--stats-dump=FILE]" << endl;
+            cerr << "       " << argv[0] << " [--search=...] [--tree-cache=MB] --batch <graph file> [query file] [--directions] [--threads=N]" << endl;
+            cerr << "       " << argv[0] << " --convert <graph file> <image file>" << endl;
+            return 1;
+        }
+    }
+    if (showStats || !statsFile.empty()) gm.set_stats(showStats, statsFile);
+
+    // Batch mode: exit status 0 if every query was answered, 2 if some query line was malformed,
+    // 1 if the graph, the query file or the output could not be used
+    if (batch) {
+        ios::sync_with_stdio(false);
+        if (!gm.load(batchGraph)) return 1;
+        int status;
+        if (batchQueries.empty()) {
+            status = gm.run_batch(cin, cout, withDirections, threads);
+        } else {
+            ifstream queries(batchQueries);
+            if (!queries.is_open()) {
+                cerr << "Could not open file: " << batchQueries << endl;
+                return 1;
+            }
+            status = gm.run_batch(queries, cout, withDirections, threads);
+        }
+        ShortestPathTreeCache::Stats st = gm.tree_cache_stats();
+        if (st.hits + st.misses > 0) {
+            cerr << "Tree cache: " << st.hits << " hits, " << st.misses << " misses, " << st.evictions << " evictions" << endl;
+        }
+        if (!gm.report_stats(cerr) && status == 0) status = 1;
+        return status;
+    }
+
     // Welcome message and load the graph
-    // The program prompts the user to enter a file name to load the graph
+    // The program prompts the user to enter a file name to load the graph,
+    // either a text graph or a binary image (the format is detected from the file)
     cout << "Welcome to CLI route planner! (enter 'q' to quit)" << endl;
-    GraphMap gm;
     while (!gm.load_file()) { /* retry */ }
     while (true) {
         // Prompt the user to enter start and end coordinates, then find the shortest path.
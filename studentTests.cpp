@@ -8,11 +8,56 @@ Written by: Khoi V.
 #include <cmath>   // for fabs
 #include <fstream>
 #include <vector>
+#include <algorithm> // for sort, adjacent_find
 #include "DirectedGraph.hpp"
 #include "Vertex.hpp"
+#include "GreatCircleHeuristic.hpp"
+#include "ContractionHierarchy.hpp"
+#include "QueryExecutor.hpp"
+#include "GraphFile.hpp"
+#include "GraphImage.hpp"
+#include "SpatialIndex.hpp"
+#include "ShortestPathTreeCache.hpp"
+#include "SearchStats.hpp"
+#include "Arena.hpp"
+#include "NameTable.hpp"
+#include "CLI.hpp"
+#include <sstream>
 
 using namespace std;
 
+// Adds a side x side grid of vertices 0 .. side * side - 1 to g, with edges both ways between neighbours
+// weight(from, to) gives the weight of each edge; it is called right, left, down, up for each vertex in order
+// Returns the vertices in index order
+template <typename Weight>
+vector<Vertex<int>*> makeGrid(DirectedGraph<int>& g, int side, Weight weight) {
+    vector<Vertex<int>*> cells;
+    for (int i = 0; i < side * side; ++i) {
+        cells.push_back(new Vertex<int>(i));
+        g.addVertex(cells[i]);
+    }
+    for (int i = 0; i < side * side; ++i) {
+        if (i % side < side - 1) {
+            g.addEdge(cells[i], cells[i + 1], weight(i, i + 1));
+            g.addEdge(cells[i + 1], cells[i], weight(i + 1, i));
+        }
+        if (i < side * (side - 1)) {
+            g.addEdge(cells[i], cells[i + side], weight(i, i + side));
+            g.addEdge(cells[i + side], cells[i], weight(i + side, i));
+        }
+    }
+    return cells;
+}
+
+// Grid weights from 1 to 6 that differ with the position and the direction of the edge
+double mixedWeight(int from, int to) {
+    int i = min(from, to);
+    if (to == from + 1) return 1.0 + (i * 7) % 5;
+    if (from == to + 1) return 1.0 + (i * 3) % 4;
+    if (to > from) return 1.0 + (i * 5) % 6;
+    return 1.0 + (i * 11) % 3;
+}
+
 int main() {
     // 1) test addVertex + getVertices
     DirectedGraph<int> g;
@@ -89,6 +134,627 @@ int main() {
     assert(path[1].first == verts3[1] && fabs(path[1].second - 1.5) < 1e-6);
     assert(path[2].first == verts3[2] && fabs(path[2].second - 4.0) < 1e-6);
 
+    // 6) test the CSR snapshot: same edges, names in the side table, same distances
+    const CSRGraph<int>& net = g3.snapshot();
+    assert(net.numVertices() == 3 && net.numEdges() == 3);
+    assert(net.find(2) == 2);
+    size_t e01 = net.findEdge(0, 1);
+    assert(e01 != CSRGraph<int>::NONE && net.edgeTarget(e01) == 1);
+    assert(net.edgeName(e01) == "Edge A street");
+    assert(net.findEdge(0, 2) == CSRGraph<int>::NONE);
+    vector<double> dist;
+    vector<size_t> parent;
+    net.Dijkstra(0, dist, parent);
+    assert(fabs(dist[1] - 1.5) < 1e-6 && fabs(dist[2] - 4.0) < 1e-6);
+    assert(net.route(parent, 2) == vector<size_t>({0, 1, 2}));
+
+    // 7) test minPQ and the indexed d-ary PQ: pops come out in key order after key updates
+    minPQ<int, char> mpq(8);
+    int keys[] = {7, 3, 9, 5, 8};
+    char vals[] = {'a', 'b', 'c', 'd', 'e'};
+    mpq.fromArrays(keys, vals, 5);
+    assert(mpq.pop() == make_pair(3, 'b'));
+    mpq.updateKey(1, 'e');
+    mpq.updateKey(4, 'c');
+    assert(mpq.pop().second == 'e' && mpq.pop().second == 'c');
+    assert(mpq.pop().second == 'd' && mpq.pop().second == 'a' && mpq.empty());
+
+    indexedMinPQ<int, 2> ipq2(6);
+    indexedMinPQ<int, 4> ipq4(6);
+    for (size_t i = 0; i < 6; ++i) {
+        ipq2.insert(10 - (int)i, i);
+        ipq4.insert(10 - (int)i, i);
+    }
+    assert(ipq2.insertOrDecrease(0, 2) && !ipq2.insertOrDecrease(20, 2));
+    ipq4.updateKey(0, 2);
+    assert(ipq2.top() == make_pair(0, (size_t)2) && ipq4.pop() == make_pair(0, (size_t)2));
+    ipq2.pop();
+    assert(!ipq2.contains(2) && ipq2.keyOf(5) == 5);
+    for (size_t expected : {5, 4, 3, 1, 0}) {
+        assert(ipq2.pop().second == expected && ipq4.pop().second == expected);
+    }
+    assert(ipq2.empty() && ipq4.empty());
+
+    // 8) test point-to-point and bidirectional searches against Dijkstra
+    auto p02 = g3.shortestPath(verts3[0], verts3[2]);
+    assert(fabs(p02.second - 4.0) < 1e-6);
+    assert(p02.first == vector<Vertex<int>*>({verts3[0], verts3[1], verts3[2]}));
+    auto b20 = g3.bidirectionalDijkstra(verts3[2], verts3[1]);
+    assert(fabs(b20.second - 5.0) < 1e-6);
+    assert(b20.first == vector<Vertex<int>*>({verts3[2], verts3[0], verts3[1]}));
+    vector<size_t> route12;
+    assert(net.bidirectionalDijkstra(1, 1, route12) == 0.0 && route12.size() == 1);
+
+    // 9) test A*: same result as Dijkstra with an admissible heuristic, fewer vertices settled
+    auto a02 = g3.aStar(verts3[0], verts3[2], [](Vertex<int>* x) { return x->getValue() == 2 ? 0.0 : 2.0; });
+    assert(fabs(a02.second - 4.0) < 1e-6 && a02.first.size() == 3);
+    vector<pair<double,double>> coords = {{0.0, 0.0}, {0.0, 1.0}, {0.0, 2.0}};
+    assert(fabs(GreatCircleHeuristic::distance(coords[0], coords[1]) - 111195.08) < 1.0);
+    double scale = GreatCircleHeuristic::minCostPerMetre(net, coords);
+    assert(scale > 0 && scale * GreatCircleHeuristic::distance(coords[1], coords[2]) <= 2.5);
+    size_t settledA = 0, settledD = 0;
+    assert(fabs(net.aStar(2, 1, GreatCircleHeuristic(coords, scale, 1), route12, &settledA) - 5.0) < 1e-6);
+    net.shortestPath(2, 1, route12, &settledD);
+    assert(settledA <= settledD);
+
+    // 10) test contraction hierarchies: every query matches Dijkstra and unpacks to original vertices
+    ContractionHierarchy<int> ch(net);
+    assert(ch.numVertices() == 3);
+    for (size_t s = 0; s < 3; ++s) {
+        net.Dijkstra(s, dist, parent);
+        for (size_t t = 0; t < 3; ++t) {
+            vector<size_t> chRoute;
+            assert(fabs(ch.query(s, t, chRoute) - dist[t]) < 1e-6);
+            assert(chRoute == net.route(parent, t));
+        }
+    }
+
+    // 11) test re-entrant searches: Dijkstra leaves the vertices alone, contexts are reusable,
+    // and the executor runs queries on several threads with the same answers
+    verts3[1]->setDistance(-1.0);
+    g3.Dijkstra(verts3[0]);
+    assert(verts3[1]->getDistance() == -1.0);
+    SearchContext ctx;
+    g3.Dijkstra(verts3[1], ctx);
+    assert(fabs(ctx.forward.getDistance(0) - 6.0) < 1e-6 && ctx.forward.getParent(0) == 2);
+    assert(fabs(net.shortestPath(ctx, 0, 2, route12) - 4.0) < 1e-6 && ctx.forward.getParent(1) == 0);
+    assert(fabs(ch.query(ctx, 2, 1, route12) - 5.0) < 1e-6);
+    vector<pair<size_t,size_t>> queries;
+    for (int rep = 0; rep < 50; ++rep) {
+        for (size_t s = 0; s < 3; ++s) {
+            for (size_t t = 0; t < 3; ++t) queries.push_back(make_pair(s, t));
+        }
+    }
+    QueryExecutor pool(3);
+    auto answers = pool.route(net, queries);
+    for (size_t i = 0; i < queries.size(); ++i) {
+        vector<size_t> expected;
+        assert(fabs(answers[i].second - net.shortestPath(queries[i].first, queries[i].second, expected)) < 1e-9);
+        assert(answers[i].first == expected);
+    }
+    pool.submit([](SearchContext&) { throw runtime_error("job failed"); });
+    bool rethrown = false;
+    try {
+        pool.wait();
+    } catch (const runtime_error&) {
+        rethrown = true;
+    }
+    assert(rethrown);
+
+    // 12) test the distance matrix: every entry matches a full Dijkstra, predecessors are last hops
+    vector<Vertex<int>*> rowVerts = {verts3[0], verts3[2]};
+    vector<Vertex<int>*> colVerts = {verts3[2], verts3[1], verts3[0]};
+    vector<Vertex<int>*> preds;
+    vector<double> matrix = g3.distanceMatrix(rowVerts, colVerts, &preds, 2);
+    assert(matrix.size() == 6 && preds.size() == 6);
+    for (size_t i = 0; i < rowVerts.size(); ++i) {
+        net.Dijkstra(rowVerts[i]->getIndex(), dist, parent);
+        for (size_t j = 0; j < colVerts.size(); ++j) {
+            size_t t = colVerts[j]->getIndex();
+            assert(fabs(matrix[i * 3 + j] - dist[t]) < 1e-9);
+            assert(preds[i * 3 + j] == (parent[t] == CSRGraph<int>::NONE ? nullptr : g3.getVertices()[parent[t]]));
+        }
+    }
+    assert(preds[0] == verts3[1] && preds[3] == nullptr);
+
+    // 13) test the fast loader: blank lines, CRLF line ends and edges without names
+    ofs.open(fname);
+    ofs << "2 3\n0 +1.5 -2.25\n1 3 4\r\n\n";
+    ofs << "0 1 2.5  Main St\n1 0 2.5 \n\n0 1 7\r\n";
+    ofs.close();
+    GraphFile parsed(fname, 2);
+    assert(parsed.ids == vector<size_t>({0, 1}) && parsed.coords[0] == make_pair(1.5, -2.25));
+    assert(parsed.edges.size() == 3 && parsed.edges[2].to == 1 && parsed.edges[2].weight == 7.0);
+    assert(parsed.edges[0].rest == "  Main St" && parsed.edges[1].rest == " " && parsed.edges[2].rest == "\r");
+    DirectedGraph<int> g4 = DirectedGraph<int>().readFromFile(fname);
+    auto adj4 = g4.getAdjacencyList(g4.getVertices()[0]);
+    assert(adj4.size() == 2 && get<2>(adj4[0]) == "Main St" && get<2>(adj4[1]) == "");
+    assert(get<2>(g4.getAdjacencyList(g4.getVertices()[1])[0]) == "");
+    bool malformed = false;
+    ofs.open(fname);
+    ofs << "1 1\n0 0 0\n0 x 1\n";
+    ofs.close();
+    try {
+        GraphFile bad(fname);
+    } catch (const runtime_error&) {
+        malformed = true;
+    }
+    assert(malformed);
+    malformed = false;
+    ofs.open(fname);
+    ofs << "99999999999999 1\n0 0 0\n"; // a vertex count far beyond what the file holds
+    ofs.close();
+    try {
+        GraphFile bad(fname);
+    } catch (const runtime_error&) {
+        malformed = true;
+    }
+    assert(malformed);
+    {
+        // an edge to an undefined vertex or a repeated vertex ID fails the load, and the next file still loads
+        GraphMap dangling;
+        ofs.open(fname);
+        ofs << "2 1\n1 0 0\n2 1 1\n1 3 5.0 Bad\n";
+        ofs.close();
+        assert(!dangling.load(fname));
+        ofs.open(fname);
+        ofs << "2 1\n1 0 0\n1 1 1\n1 1 5.0 Bad\n";
+        ofs.close();
+        assert(!dangling.load(fname));
+        ofs.open(fname);
+        ofs << "2 1\n1 0 0\n2 1 1\n1 2 5.0 Good\n";
+        ofs.close();
+        assert(dangling.load(fname));
+    }
+
+    // 14) test binary images: the mapped graph matches the snapshot, and other files are rejected
+    const string bname = "temp_graph.bin";
+    vector<pair<double,double>> coords3 = {{0.0, 0.0}, {1.0, 1.0}, {2.0, 2.0}};
+    GraphImage<int>::write(bname, net, coords3);
+    assert(GraphImage<int>::isImage(bname) && !GraphImage<int>::isImage(fname));
+    {
+        GraphImage<int> image(bname);
+        const CSRGraph<int>& mapped = image.graph();
+        assert(mapped.numVertices() == 3 && mapped.numEdges() == 3 && mapped.find(2) == 2);
+        assert(mapped.edgeName(mapped.findEdge(0, 1)) == "Edge A street");
+        assert(mapped.inEdgeSource(mapped.inEdgeBegin(0)) == 2);
+        assert(image.coordinates()[1] == make_pair(1.0, 1.0) && image.findCoordinate(2.0, 2.0) == 2);
+        assert(image.findCoordinate(2.0, 1.0) == CSRGraph<int>::NONE);
+        assert(fabs(mapped.bidirectionalDijkstra(2, 1, route12) - 5.0) < 1e-6 && route12 == vector<size_t>({2, 0, 1}));
+    }
+    bool rejected = false;
+    try {
+        GraphImage<int> image(fname);
+    } catch (const runtime_error&) {
+        rejected = true;
+    }
+    assert(rejected);
+    rejected = false;
+    try {
+        GraphImage<long long> image(bname);
+    } catch (const runtime_error&) {
+        rejected = true;
+    }
+    assert(rejected);
+    remove(bname.c_str());
+
+    // 15) test the spatial index: nearest and k-nearest vertices, and snapping to the nearest point on an edge
+    vector<pair<double,double>> coords4 = {{0.0, 0.0}, {2.0, 0.0}, {2.0, 2.0}};
+    SpatialIndex points(coords4.data(), coords4.size());
+    assert(points.size() == 3 && points.nearest(1.9, 1.2).id == 2 && points.nearest(2.0, 0.0).distance == 0.0);
+    auto twoNearest = points.nearest(0.4, 0.1, 2);
+    assert(twoNearest.size() == 2 && twoNearest[0].id == 0 && twoNearest[1].id == 1);
+    assert(points.nearest(0.0, 0.0, 5).size() == 3 && SpatialIndex().nearest(0.0, 0.0).id == SpatialIndex::NONE);
+    SpatialIndex roads(net, coords4.data());
+    SpatialIndex::Match onRoad = roads.nearest(1.0, -0.5);
+    assert(onRoad.id == e01 && net.edgeSource(onRoad.id) == 0);
+    assert(fabs(onRoad.distance - 0.5) < 1e-12 && fabs(onRoad.fraction - 0.5) < 1e-12 && onRoad.point == make_pair(1.0, 0.0));
+    assert(roads.nearest(2.0, 2.0).distance == 0.0 && fabs(SpatialIndex::lonScale(coords4.data(), 3) - cos(M_PI / 180)) < 1e-12);
+
+    // 16) test the shortest-path tree cache: hits and misses, clearing on every change, LRU eviction within the budget
+    DirectedGraph<int> g5(g3);
+    auto verts5 = g5.getVertices();
+    g5.setTreeCacheBudget(1 << 20);
+    auto cached = g5.cachedShortestPath(verts5[0], verts5[2]);
+    assert(fabs(cached.second - 4.0) < 1e-6 && cached.first == vector<Vertex<int>*>({verts5[0], verts5[1], verts5[2]}));
+    cached = g5.cachedShortestPath(verts5[0], verts5[1]);
+    assert(fabs(cached.second - 1.5) < 1e-6 && cached.first.size() == 2);
+    assert(g5.treeCache().stats().hits == 1 && g5.treeCache().stats().misses == 1 && g5.treeCache().stats().trees == 1);
+    g5.addEdge(verts5[0], verts5[2], 1.0, "Shortcut");
+    assert(g5.treeCache().stats().trees == 0);
+    cached = g5.cachedShortestPath(verts5[0], verts5[2]);
+    assert(fabs(cached.second - 1.0) < 1e-6 && cached.first == vector<Vertex<int>*>({verts5[0], verts5[2]}));
+    g5.removeEdge(verts5[0], verts5[2]);
+    cached = g5.cachedShortestPath(verts5[0], verts5[2]);
+    assert(fabs(cached.second - 4.0) < 1e-6 && g5.treeCache().stats().misses == 3);
+    g5.removeVertex(verts5[1]);
+    cached = g5.cachedShortestPath(g5.getVertices()[0], g5.getVertices()[1]);
+    assert(cached.first.empty() && cached.second == numeric_limits<double>::infinity());
+    SearchContext treeCtx;
+    bool hit = true;
+    ShortestPathTreeCache small(net.numVertices() * (sizeof(double) + sizeof(uint32_t)) + sizeof(ShortestPathTree));
+    assert(small.get(net, treeCtx, 0, &hit)->route(2) == vector<size_t>({0, 1, 2}) && !hit);
+    assert(small.get(net, treeCtx, 2)->distance[1] == 5.0 && small.get(net, treeCtx, 2, &hit)->parent[2] == ShortestPathTree::NONE && hit);
+    assert(small.stats().evictions == 1 && small.stats().trees == 1 && small.stats().bytes <= small.getBudget());
+    small = ShortestPathTreeCache(small.getBudget()); // empties the cache without counting evictions
+    assert(small.stats().evictions == 1 && small.stats().trees == 0 && small.stats().bytes == 0);
+    small.setBudget(0);
+    small.get(net, treeCtx, 2, &hit);
+    assert(!hit && small.stats().trees == 0 && small.stats().misses == 3);
+
+    // 17) test live weight updates: edge lookup and reverse adjacency, the patched snapshot and repaired trees
+    DirectedGraph<int> g6;
+    vector<Vertex<int>*> grid = makeGrid(g6, 8, mixedWeight);
+    g6.addEdge(grid[0], grid[1], 9.0, "Parallel");
+    assert(grid[0]->hasEdge(grid[1]) && !grid[0]->hasEdge(grid[9]) && grid[1]->getIncoming().size() == 4);
+    g6.setTreeCacheBudget(1 << 20);
+    const CSRGraph<int>& live = g6.snapshot();
+    g6.cachedShortestPath(grid[0], grid[63]);
+    g6.cachedShortestPath(grid[27], grid[0]);
+    unsigned seed = 7;
+    for (int round = 0; round < 20; ++round) {
+        vector<tuple<Vertex<int>*, Vertex<int>*, double>> changes;
+        for (int k = 0; k < 6; ++k) {
+            seed = seed * 1103515245 + 12345;
+            Vertex<int>* a = grid[(seed >> 8) % 64];
+            auto &adj = a->getAdjacencyList();
+            Vertex<int>* b = get<0>(adj[(seed >> 16) % adj.size()]);
+            changes.push_back(make_tuple(a, b, round % 2 == 0 ? 0.5 + (seed >> 4) % 3 : 4.0 + (seed >> 4) % 7));
+        }
+        g6.updateEdgeWeights(changes);
+        assert(&g6.snapshot() == &live && live.edgeWeight(live.findEdge(get<0>(changes[0])->getIndex(),
+                                                                         get<1>(changes[0])->getIndex())) <= get<2>(changes[0]));
+        for (int s : {0, 27}) {
+            live.Dijkstra(s, dist, parent);
+            for (int t = 0; t < 64; ++t) {
+                auto repaired = g6.cachedShortestPath(grid[s], grid[t]);
+                assert(fabs(repaired.second - dist[t]) < 1e-9 && repaired.first.front() == grid[s] && repaired.first.back() == grid[t]);
+            }
+        }
+    }
+    assert(g6.treeCache().stats().misses == 2 && g6.treeCache().stats().trees == 2);
+    g6.updateEdgeWeight(grid[0], grid[1], 0.25);
+    assert(get<1>(grid[0]->getAdjacencyList()[0]) == 0.25 && get<1>(grid[0]->getAdjacencyList().back()) == 9.0);
+    assert(g6.cachedShortestPath(grid[0], grid[1]).second == 0.25);
+    bool missing = false;
+    try {
+        g6.updateEdgeWeight(grid[0], grid[9], 1.0);
+    } catch (const runtime_error&) {
+        missing = true;
+    }
+    assert(missing);
+    g6.removeEdge(grid[0], grid[1]);
+    assert(grid[0]->hasEdge(grid[1]) && get<1>(grid[0]->getAdjacencyList().back()) == 9.0 && grid[1]->getIncoming().size() == 3);
+    g6.removeVertex(grid[9]);
+    assert(g6.getVertices().size() == 63 && grid[1]->getIncoming().size() == 2 && grid[17]->getIncoming().size() == 3);
+    for (Vertex<int>* u : g6.getVertices()) {
+        for (auto &e : u->getAdjacencyList()) assert(get<0>(e) != grid[9]);
+    }
+
+    // 18) test the search statistics: histogram buckets and percentiles, the registry dump and, in builds with
+    // ROUTE_STATS, the counters the searches fill in
+    LatencyHistogram hist;
+    for (double us : {0.5, 3.0, 3.5, 100.0}) hist.record(us);
+    assert(hist.count() == 4 && hist.bucket(0) == 1 && hist.bucket(2) == 2 && hist.bucket(7) == 1);
+    assert(hist.percentile(0.5) == 4.0 && hist.percentile(1.0) == 128.0 && fabs(hist.mean() - 26.75) < 1e-6);
+    hist.clear();
+    assert(hist.count() == 0 && hist.percentile(0.5) == 0.0);
+    SearchStatsRegistry registry;
+    QueryStats one;
+    one.settled = 7;
+    one.phaseUs[static_cast<size_t>(QueryPhase::TOTAL)] = 10.0;
+    registry.record(one);
+    stringstream dumped;
+    registry.dump(dumped);
+    assert(dumped.str().find("{\"queries\":1,\"settled\":7,") == 0 && dumped.str().find("\"total\":{\"count\":1") != string::npos);
+#ifdef ROUTE_STATS
+    const CSRGraph<int>& stats = g6.snapshot();
+    SearchContext statsCtx;
+    size_t statsSettled = 0;
+    {
+        QueryScope query(statsCtx.stats);
+        stats.shortestPath(statsCtx, 0, stats.numVertices() - 1, route12, &statsSettled);
+    }
+    assert(statsCtx.stats.settled == statsSettled && statsCtx.stats.relaxed >= statsSettled);
+    assert(statsCtx.stats.pushes >= statsSettled && statsCtx.stats.phaseUs[static_cast<size_t>(QueryPhase::TOTAL)] > 0.0);
+    stringstream globalDump;
+    SearchStatsRegistry::global().dump(globalDump);
+    assert(globalDump.str().find("{\"queries\":1,\"settled\":" + to_string(statsSettled) + ",") == 0);
+#endif
+
+    // 19) test the arena: aligned bump allocation, chunk growth and big blocks, then arena vertices created next to
+    // heap vertices, removed, copied and assigned
+    {
+        Arena arena;
+        char* a = static_cast<char*>(arena.allocate(3, 1));
+        double* b = static_cast<double*>(arena.allocate(sizeof(double), alignof(double)));
+        assert(reinterpret_cast<uintptr_t>(b) % alignof(double) == 0 && reinterpret_cast<char*>(b) - a < 16);
+        assert(arena.capacity() == Arena::MIN_CHUNK && arena.used() == 3 + sizeof(double));
+        void* second = arena.allocate(Arena::MIN_CHUNK, 64);
+        assert(reinterpret_cast<uintptr_t>(second) % 64 == 0);
+        assert(arena.capacity() == 3 * Arena::MIN_CHUNK);
+        void* big = arena.allocate(Arena::MAX_CHUNK, 256);
+        assert(reinterpret_cast<uintptr_t>(big) % 256 == 0 && arena.capacity() == 3 * Arena::MIN_CHUNK + 256 + Arena::MAX_CHUNK);
+        arena.release();
+        assert(arena.capacity() == 0 && arena.used() == 0);
+        pmr::vector<int> numbers(&arena);
+        for (int i = 0; i < 1000; ++i) numbers.push_back(i);
+        assert(numbers[999] == 999 && arena.used() >= 1000 * sizeof(int));
+    }
+    {
+        DirectedGraph<int> g7;
+        Vertex<int>* heap = new Vertex<int>(100);
+        g7.addVertex(heap);
+        vector<Vertex<int>*> made;
+        for (int i = 0; i < 5; ++i) made.push_back(g7.createVertex(i));
+        assert(heap->getMemory() == pmr::get_default_resource() && made[0]->getMemory() != heap->getMemory());
+        assert(made[4]->getIndex() == 5 && made[4]->getValue() == 4);
+        for (int i = 0; i < 4; ++i) g7.addEdge(made[i], made[i + 1], i + 1.0, "Arena Road " + to_string(i));
+        g7.addEdge(heap, made[0], 0.5, "Heap Street");
+        g7.addEdge(made[4], heap, 7.0);
+        g7.removeVertex(made[2]);
+        assert(g7.getVertices().size() == 5 && made[3]->getIndex() == 3 && made[3]->getIncoming().empty());
+        assert(made[1]->getAdjacencyList().empty() && made[4]->getIncoming().size() == 1);
+        DirectedGraph<int> g8(g7);
+        vector<Vertex<int>*> copied = g8.getVertices();
+        assert(copied.size() == 5 && copied[0]->getMemory() == copied[4]->getMemory() && copied[0]->getMemory() != made[0]->getMemory());
+        for (size_t i = 0; i < copied.size(); ++i) {
+            assert(copied[i]->getIndex() == i && copied[i]->getValue() == g7.getVertices()[i]->getValue());
+            auto orig = g7.getAdjacencyList(g7.getVertices()[i]), copy = g8.getAdjacencyList(copied[i]);
+            assert(orig.size() == copy.size() && copied[i]->getIncoming().size() == g7.getVertices()[i]->getIncoming().size());
+            for (size_t k = 0; k < orig.size(); ++k) {
+                assert(get<0>(copy[k]) == copied[get<0>(orig[k])->getIndex()] && get<1>(copy[k]) == get<1>(orig[k]) && get<2>(copy[k]) == get<2>(orig[k]));
+            }
+        }
+        assert(g8.shortestPath(copied[0], copied[2]).second == 1.5 && g8.shortestPath(copied[3], copied[0]).second == 11.0);
+        g8 = g3;
+        assert(g8.getVertices().size() == g3.getVertices().size() && fabs(g8.shortestPath(g8.getVertices()[1], g8.getVertices()[0]).second - 6.0) < 1e-6);
+        g8 = g7;
+        assert(g8.getVertices().size() == 5 && g8.getVertices()[3]->getAdjacencyList().size() == 1);
+    }
+
+    // 20) test pooled lists and result buffers: node reuse, O(1) splice, bulk append, indexing in order, and Dijkstra
+    // filling caller buffers without reallocating them
+    {
+        DoublyLinkedList<int> a, b(a.getPool());
+        vector<int> first = {1, 2, 3}, second = {10, 20};
+        a.append(first.begin(), first.end());
+        b.append(second.begin(), second.end());
+        a.splice(1, b);
+        assert(a.size() == 5 && b.empty() && a[0] == 1 && a[1] == 10 && a[2] == 20 && a[3] == 2 && a[4] == 3);
+        a.erase(2);
+        a.insert(7, 3);
+        a.push_front(0);
+        assert(a.size() == 6 && a[0] == 0 && a[2] == 10 && a[3] == 2 && a[4] == 7 && a[5] == 3);
+        size_t nodes = a.getPool()->capacity();
+        for (int rep = 0; rep < 3; ++rep) {
+            a.clear();
+            for (int i = 0; i < 5; ++i) a.push_back(i);
+        }
+        assert(a.getPool()->capacity() == nodes && a.getPool()->available() == nodes - 5);
+        for (size_t i = 0; i < a.size(); ++i) assert(a[i] == static_cast<int>(i));
+        assert(a[4] == 4 && a[1] == 1 && a.search(3) == 3 && a[3] == 3 && a.pop_back() == 4 && a[3] == 3);
+        DoublyLinkedList<int> other; // its own pool, so splicing copies
+        other.push_back(42);
+        a.splice(other);
+        b.splice(a); // b is empty, so it takes the elements in O(1)
+        assert(other.empty() && a.empty() && b.size() == 5 && b[4] == 42 && b[0] == 0);
+        size_t bNodes = b.getPool()->capacity();
+        DoublyLinkedList<int> shorter;
+        shorter.append(second.begin(), second.end());
+        b = shorter; // copy assignment overwrites b's nodes, taking none from another pool
+        b = b;
+        assert(b.size() == 2 && b[0] == 10 && b[1] == 20 && b.getPool()->capacity() == bNodes && b.getPool() != shorter.getPool());
+        DoublyLinkedList<string> names;
+        names.push_back("kept");
+        names.push_back("dropped");
+        names.pop_back();
+        DoublyLinkedList<string> names2(names);
+        names2 = names.concatenate(names2);
+        assert(names2.size() == 2 && names2[1] == "kept" && names.getPool() != names2.getPool());
+
+        SearchContext bufCtx;
+        vector<double> bufDist;
+        vector<size_t> bufParent;
+        g3.Dijkstra(verts3[0], bufCtx, bufDist, bufParent);
+        const double* data = bufDist.data();
+        auto asList = g3.Dijkstra(verts3[1]);
+        for (int rep = 0; rep < 3; ++rep) {
+            g3.Dijkstra(verts3[1], bufCtx, bufDist, bufParent);
+        }
+        assert(bufDist.data() == data && bufDist.size() == g3.getVertices().size() && bufParent[1] == CSRGraph<int>::NONE);
+        for (size_t i = 0; i < asList.size(); ++i) {
+            assert(asList[i].first == g3.getVertices()[i] && asList[i].second == bufDist[i]);
+            assert(bufParent[i] == CSRGraph<int>::NONE || bufDist[bufParent[i]] < bufDist[i]);
+        }
+    }
+
+    // 21) test delta-stepping: the same distances as Dijkstra for any bucket width and thread count, zero-weight edges
+    // and ties included, with every parent on a shortest path
+    {
+        DirectedGraph<int> g9;
+        unsigned state = 11;
+        // random weights from 0 to 6, so there are zero-weight edges and ties; the edges down get 0.5 more
+        vector<Vertex<int>*> cells = makeGrid(g9, 20, [&state](int from, int to) {
+            state = state * 1103515245u + 12345u;
+            return static_cast<double>((state >> 16) % 7) + (to == from + 20 ? 0.5 : 0.0);
+        });
+        cells.push_back(new Vertex<int>(400)); // unreachable
+        g9.addVertex(cells[400]);
+        SearchContext dsCtx;
+        vector<double> expected, dist;
+        vector<size_t> expectedParent, parent;
+        const CSRGraph<int>& net = g9.snapshot();
+        for (int source : {0, 210, 399}) {
+            g9.Dijkstra(cells[source], dsCtx, expected, expectedParent);
+            for (double delta : {0.0, 0.25, 3.0, 1000.0}) {
+                for (size_t threads : {1, 3}) {
+                    g9.deltaStepping(cells[source], dist, parent, delta, threads);
+                    assert(dist == expected && parent[source] == CSRGraph<int>::NONE && parent[400] == CSRGraph<int>::NONE);
+                    for (size_t v = 0; v < 400; ++v) {
+                        if (v == static_cast<size_t>(source)) continue;
+                        assert(parent[v] != CSRGraph<int>::NONE);
+                        assert(dist[parent[v]] + net.edgeWeight(net.findEdge(parent[v], v)) == dist[v]);
+                    }
+                }
+            }
+        }
+        g9.Dijkstra(cells[0], dsCtx, expected, expectedParent);
+        DeltaStepping<int> search(net, 2);
+        search.run(0, dist, parent);
+        assert(search.numThreads() == 2 && search.rounds() > 1 && dist == expected);
+        try {
+            search.run(0, dist, parent, -1.0);
+            assert(false);
+        } catch (const invalid_argument&) {
+        }
+    }
+
+    // 22) test isochrones: exactly the vertices a full search finds within budget (the budget included), nearest first,
+    // and from several sources the distance to the nearest of them
+    {
+        DirectedGraph<int> g10;
+        vector<Vertex<int>*> blocks = makeGrid(g10, 10, mixedWeight);
+        SearchContext isoCtx;
+        vector<double> fromA, fromB;
+        vector<size_t> parents;
+        g10.Dijkstra(blocks[0], isoCtx, fromA, parents);
+        g10.Dijkstra(blocks[55], isoCtx, fromB, parents);
+        for (double budget : {0.0, 3.0, fromA[27], 1e9}) {
+            auto single = g10.isochrone(blocks[0], budget);
+            auto multi = g10.isochrone({blocks[0], blocks[55], blocks[0]}, budget, isoCtx);
+            size_t inA = 0, inAB = 0;
+            for (size_t i = 0; i < 100; ++i) {
+                inA += fromA[i] <= budget;
+                inAB += min(fromA[i], fromB[i]) <= budget;
+            }
+            assert(single.size() == inA && multi.size() == inAB);
+            for (size_t k = 0; k < single.size(); ++k) {
+                assert(single[k].second == fromA[single[k].first->getIndex()] && single[k].second <= budget);
+                assert(k == 0 || single[k - 1].second <= single[k].second);
+            }
+            for (auto &[v, d] : multi) assert(d == min(fromA[v->getIndex()], fromB[v->getIndex()]));
+        }
+        assert(g10.isochrone(blocks[0], 0.0).size() == 1 && g10.isochrone(blocks[0], -1.0).empty());
+        vector<pair<size_t,double>> reached;
+        g10.snapshot().reachable(isoCtx, {{99, 2.0}, {99, 1.0}}, 1.0, reached);
+        assert(reached.size() == 1 && reached[0] == make_pair(size_t(99), 1.0) && isoCtx.forward.getParent(99) == CSRGraph<int>::NONE);
+    }
+
+    // 23) test compact edges: names interned once and shared by every graph, and float and fixed-point weight types
+    {
+        uint32_t main = NameTable::global().intern("Main St");
+        assert(NameTable::global().intern(string("Main") + " St") == main && NameTable::global().intern("") == 0);
+        assert(NameTable::global().name(main) == "Main St" && get<2>(g4.getVertices()[0]->getAdjacencyList()[0]) == main);
+        assert(sizeof(Vertex<int, float>::Edge) < sizeof(Vertex<int>::Edge));
+
+        ofs.open(fname);
+        ofs << "3 3\n0 0 0\n1 1 1\n2 2 2\n0 1 2.5 Main St\n1 2 1.25 Elm St\n0 2 4.75 Main St\n";
+        ofs.close();
+        DirectedGraph<int, float> light = DirectedGraph<int, float>().readFromFile(fname);
+        DirectedGraph<int, uint32_t> fixed = DirectedGraph<int, uint32_t>().readFromFile(fname);
+        auto lightAdj = light.getAdjacencyList(light.getVertices()[0]);
+        assert(get<1>(lightAdj[0]) == 2.5f && get<2>(lightAdj[0]) == "Main St" && get<2>(lightAdj[1]) == "Main St");
+        assert(get<2>(light.getVertices()[0]->getAdjacencyList()[1]) == main);
+        auto fixedAdj = fixed.getAdjacencyList(fixed.getVertices()[0]);
+        assert(get<1>(fixedAdj[0]) == 2500u && get<1>(fixedAdj[1]) == 4750u); // in thousandths
+        assert(light.shortestPath(light.getVertices()[0], light.getVertices()[2]).second == 3.75);
+        assert(fabs(fixed.shortestPath(fixed.getVertices()[0], fixed.getVertices()[2]).second - 3.75) <= 1e-3);
+        fixed.updateEdgeWeight(fixed.getVertices()[0], fixed.getVertices()[2], WeightTraits<uint32_t>::toWeight(0.5004));
+        assert(get<1>(fixed.getAdjacencyList(fixed.getVertices()[0])[1]) == 500u);
+        assert(fixed.shortestPath(fixed.getVertices()[0], fixed.getVertices()[2]).second == 0.5);
+        ofs.open(fname);
+        ofs << "2 1\n0 0 0\n1 1 1\n0 1 -2.5 Back St\n";
+        ofs.close();
+        try {
+            DirectedGraph<int, uint32_t>().readFromFile(fname);
+            assert(false);
+        } catch (const out_of_range&) {
+        }
+        assert(WeightTraits<uint16_t>::toWeight(65.5) == 65500u);
+        try {
+            WeightTraits<uint16_t>::toWeight(65.6); // 65600 thousandths do not fit 16 bits
+            assert(false);
+        } catch (const out_of_range&) {
+        }
+        const CSRGraph<int>& lightNet = light.snapshot();
+        assert(lightNet.edgeName(lightNet.findEdge(1, 2)) == "Elm St" && lightNet.edgeName(lightNet.findEdge(0, 2)) == "Main St");
+
+        DirectedGraph<int, float> lightCopy(light);
+        lightCopy.updateEdgeWeight(lightCopy.getVertices()[0], lightCopy.getVertices()[2], 0.5f);
+        lightCopy.addEdge(lightCopy.getVertices()[2], lightCopy.getVertices()[0], 1.0f, "Elm St");
+        auto copyAdj = lightCopy.getAdjacencyList(lightCopy.getVertices()[2]);
+        assert(get<2>(copyAdj[0]) == "Elm St" && get<2>(copyAdj[0]) == get<2>(light.getAdjacencyList(light.getVertices()[1])[0]));
+        assert(lightCopy.shortestPath(lightCopy.getVertices()[0], lightCopy.getVertices()[2]).second == 0.5);
+        assert(light.shortestPath(light.getVertices()[0], light.getVertices()[2]).second == 3.75);
+    }
+
+    // 24) test alternative routes: the shortest route first, then distinct simple routes within the stretch that share
+    // at most maxOverlap of the shortest length with every route before them
+    {
+        DirectedGraph<int> g12;
+        // weights from 2 to 5, close enough for several routes to stay within the stretch
+        vector<Vertex<int>*> cells = makeGrid(g12, 12, [](int from, int to) {
+            int i = min(from, to);
+            if (to == from + 1) return 2.0 + (i * 7) % 3;
+            if (from == to + 1) return 2.0 + (i * 5) % 3;
+            if (to > from) return 2.0 + (i * 3) % 4;
+            return 2.0 + (i * 11) % 4;
+        });
+        const CSRGraph<int>& net12 = g12.snapshot();
+        auto weight = [&](Vertex<int>* a, Vertex<int>* b) { return net12.edgeWeight(net12.findEdge(a->getIndex(), b->getIndex())); };
+        auto shared = [&](const vector<Vertex<int>*>& a, const vector<Vertex<int>*>& b) {
+            double len = 0.0;
+            for (size_t i = 0; i + 1 < a.size(); ++i) {
+                for (size_t j = 0; j + 1 < b.size(); ++j) {
+                    if (a[i] == b[j] && a[i + 1] == b[j + 1]) len += weight(a[i], a[i + 1]);
+                }
+            }
+            return len;
+        };
+        for (auto [s, t] : {make_pair(0, 143), make_pair(5, 138), make_pair(130, 13)}) {
+            auto best = g12.shortestPath(cells[s], cells[t]);
+            for (double overlap : {0.0, 0.5, 0.75}) {
+                AlternativeLimits limits;
+                limits.count = 4;
+                limits.maxOverlap = overlap;
+                auto routes = g12.alternativeRoutes(cells[s], cells[t], limits);
+                assert(!routes.empty() && routes.size() <= 4);
+                assert(routes[0].second == best.second); // on ties the route itself may differ
+                for (size_t k = 0; k < routes.size(); ++k) {
+                    auto &[path, len] = routes[k];
+                    assert(path.front() == cells[s] && path.back() == cells[t]);
+                    assert(len <= 1.25 * best.second + 1e-9);
+                    double sum = 0.0;
+                    for (size_t i = 0; i + 1 < path.size(); ++i) sum += weight(path[i], path[i + 1]);
+                    assert(fabs(sum - len) < 1e-9);
+                    vector<Vertex<int>*> sorted(path);
+                    sort(sorted.begin(), sorted.end());
+                    assert(adjacent_find(sorted.begin(), sorted.end()) == sorted.end());
+                    for (size_t j = 0; j < k; ++j) {
+                        assert(routes[j].first != path && shared(routes[j].first, path) <= overlap * best.second + 1e-9);
+                    }
+                }
+                if (overlap == 0.75) assert(routes.size() >= 2);
+            }
+        }
+        AlternativeLimits one;
+        one.count = 1;
+        assert(g12.alternativeRoutes(cells[0], cells[143], one).size() == 1);
+        DirectedGraph<int> island;
+        Vertex<int>* lone[2] = {new Vertex<int>(0), new Vertex<int>(1)};
+        island.addVertex(lone[0]);
+        island.addVertex(lone[1]);
+        assert(island.alternativeRoutes(lone[0], lone[1]).empty());
+        AlternativeLimits bad;
+        bad.maxOverlap = 1.5;
+        try {
+            g12.alternativeRoutes(cells[0], cells[143], bad);
+            assert(false);
+        } catch (const invalid_argument&) {
+        }
+    }
+
     remove(fname.c_str());
     cout << "All DirectedGraph tests passed.\n";
     return 0;